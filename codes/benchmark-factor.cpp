@@ -0,0 +1,36 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "primes.hpp"
+#include "benchmark.hpp"
+
+//a random prime in [2^(bits - 1), 2^bits)
+std::uint64_t random_prime(std::mt19937_64& engine, int bits) {
+    while (true) {
+        std::uint64_t candidate = (engine() >> (64 - bits)) | (std::uint64_t(1) << (bits - 1)) | 1;
+        if (UMJCUtil::Math::MillerRabin::is_prime(candidate)) return candidate;
+    }
+}
+
+//usage: benchmark-factor [count]
+//factors `count` random 62-bit semiprimes p * q with p, q 31-bit primes, the hardest case for rho at this size.
+int main(int argc, char* argv[]) {
+    const std::size_t count = argc > 1 ? std::stoull(argv[1]) : 10'000;
+    std::mt19937_64 engine(20240601);
+    std::vector<std::uint64_t> semiprimes(count);
+    for (auto& n : semiprimes) n = random_prime(engine, 31) * random_prime(engine, 31);
+    std::size_t checked = 0;
+    double seconds = UMJCUtil::Bench::measure_seconds([&] {
+        checked = 0;
+        for (auto n : semiprimes) {
+            auto factors = UMJCUtil::Math::Primes<std::uint64_t>::factor(n);
+            if (factors.size() == 2 && factors[0].first * factors[1].first == n) checked++;
+        }
+    });
+    std::cout << std::setw(12) << "semiprimes" << std::setw(14) << "total [s]" << std::setw(14) << "per call [us]" << std::setw(14) << "correct" << "\n";
+    std::cout << std::setw(12) << count << std::setw(14) << seconds << std::setw(14) << seconds / count * 1e6 << std::setw(14) << checked << "\n";
+    return checked == count ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "format-sink.hpp"
+#include "benchmark.hpp"
+
+//what every generator used to carry: log10 twice and pow once per cell
+std::pair<int, int> legacy_sci_notation(double x, int digits = 5) {
+    if (x == 0.0) return std::make_pair<int, int>(0, 0);
+    else {
+        int significands = static_cast<int>(std::round(x * std::pow(10.0, -std::floor(std::log10(x)) + static_cast<double>(digits) - 1.0)));
+        int exp = static_cast<int>(std::floor(std::log10(x)));
+        int significands_max = 1;
+        for (int i = 0; i < digits; i++) significands_max *= 10;
+        if (significands == significands_max) {
+            significands /= 10;
+            ++exp;
+        }
+        return std::make_pair(significands, exp);
+    }
+}
+
+//usage: benchmark-format [cells]
+//writes `cells` random values as table cells, through chained iostream calls as before and through FormatSink.
+int main(int argc, char* argv[]) {
+    const std::size_t cells = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::mt19937_64 engine(20240601);
+    std::uniform_real_distribution<double> exponent(-8.0, 8.0);
+    std::vector<double> values(cells);
+    for (auto& x : values) x = std::pow(10.0, exponent(engine));
+
+    std::ostringstream legacy_out, sink_out;
+    double legacy = UMJCUtil::Bench::measure_seconds([&] {
+        legacy_out.str("");
+        std::ios_base::fmtflags old_flags;
+        for (std::size_t i = 0; i < cells; i++) {
+            std::pair<int, int> sci = legacy_sci_notation(values[i], 5);
+            old_flags = legacy_out.flags();
+            legacy_out << "\\({" << sci.first << "}_{" << std::showpos << sci.second << std::noshowpos << "}\\)" << (i % 10 != 9 ? " & " : "\\\\\n");
+            legacy_out.flags(old_flags);
+        }
+    }, 3);
+    double sink = UMJCUtil::Bench::measure_seconds([&] {
+        sink_out.str("");
+        UMJCUtil::Tables::FormatSink out(sink_out, cells * 24);
+        for (std::size_t i = 0; i < cells; i++) {
+            out.sci(values[i]);
+            out.text(i % 10 != 9 ? " & " : "\\\\\n");
+        }
+    }, 3);
+
+    //cells the two round differently; the sink is the exactly rounded one
+    std::size_t differ = 0;
+    for (double x : values) differ += legacy_sci_notation(x) != UMJCUtil::Tables::get_sci_notation(x);
+    std::cout << std::setw(12) << "method" << std::setw(14) << "total [s]" << std::setw(16) << "cells / s" << "\n";
+    std::cout << std::setw(12) << "iostream" << std::setw(14) << legacy << std::setw(16) << cells / legacy << "\n";
+    std::cout << std::setw(12) << "FormatSink" << std::setw(14) << sink << std::setw(16) << cells / sink << "\n";
+    std::cout << differ << " of " << cells << " cells round differently\n";
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "isqrt.hpp"
+#include "benchmark.hpp"
+
+//the bit-by-bit digit loop isqrt() used to run, kept for comparison
+template <typename T>
+T legacy_isqrt(T x) {
+    std::size_t bit_size = std::numeric_limits<T>::digits;
+    if (bit_size % 2 != 0) bit_size++;
+    T rtrn(0);
+    T multiplier(T(1) << (bit_size - 2));
+    T subtracted(x);
+    for (T i = T(0); i < T(bit_size / 2); i++) {
+        T j = ((rtrn << 2) + T(1)) * multiplier > subtracted ? T(0) : T(1);
+        if (j) subtracted -= ((rtrn << 2) + T(1)) * multiplier;
+        rtrn <<= 1;
+        rtrn |= j;
+        multiplier >>= 2;
+    }
+    return rtrn;
+}
+
+//floor(sqrt(x)) by definition: r^2 <= x < (r + 1)^2, checked without squaring past the type
+template <typename T>
+bool is_floor_root(T x, T r) {
+    return r <= x / (r == T(0) ? T(1) : r) && (r + T(1) > x / (r + T(1)));
+}
+
+//random values spread over every magnitude of T: a random bit length, then random bits below it
+template <typename T>
+std::vector<T> random_values(std::mt19937_64& engine, std::size_t count) {
+    using U = std::make_unsigned_t<T>;
+    std::vector<T> rtrn(count);
+    for (auto& x : rtrn) {
+        U bits = U(engine());
+        if constexpr (std::numeric_limits<U>::digits > 64) bits = (bits << 64) | U(engine());
+        int length = static_cast<int>(engine() % (std::numeric_limits<T>::digits + 1));
+        x = static_cast<T>(length == 0 ? U(0) : bits >> (std::numeric_limits<U>::digits - length));
+    }
+    return rtrn;
+}
+
+template <typename T>
+bool compare(const std::string& type, const std::vector<T>& values) {
+    T sum = 0;
+    double legacy = UMJCUtil::Bench::measure_seconds([&] {
+        sum = 0;
+        for (T x : values) sum += legacy_isqrt(x);
+        UMJCUtil::Bench::do_not_optimize(sum);
+    }, 3);
+    double current = UMJCUtil::Bench::measure_seconds([&] {
+        sum = 0;
+        for (T x : values) sum += UMJCUtil::Math::isqrt(x);
+        UMJCUtil::Bench::do_not_optimize(sum);
+    }, 3);
+    std::size_t wrong = 0;
+    for (T x : values) wrong += !is_floor_root(x, UMJCUtil::Math::isqrt(x));
+    std::cout << std::setw(10) << type << std::setw(16) << legacy / values.size() * 1e9 << std::setw(16) << current / values.size() * 1e9 << std::setw(10) << legacy / current << std::setw(8) << wrong << "\n";
+    return wrong == 0;
+}
+
+//every edge case at once: squares, their neighbours and the largest value of the type
+template <typename T>
+std::vector<T> edge_values() {
+    using U = std::make_unsigned_t<T>;
+    std::vector<T> rtrn = { std::numeric_limits<T>::max(), T(std::numeric_limits<T>::max() - 1) };
+    for (int bits = 0; bits < std::numeric_limits<T>::digits / 2 + 1; bits++) {
+        U root = (U(1) << bits) - U(1);
+        for (U r : { root, U(root + 1), U(root - 1) }) {
+            if (r == U(0) || r > std::numeric_limits<T>::max() / r) continue;
+            rtrn.push_back(static_cast<T>(r * r));
+            rtrn.push_back(static_cast<T>(r * r - 1));
+            if (r * r < U(std::numeric_limits<T>::max())) rtrn.push_back(static_cast<T>(r * r + 1));
+        }
+    }
+    return rtrn;
+}
+
+template <typename T>
+bool run(const std::string& type, std::mt19937_64& engine, std::size_t count) {
+    //the Newton path taken in constant evaluation
+    constexpr T root_of_max = UMJCUtil::Math::isqrt(std::numeric_limits<T>::max());
+    if (!is_floor_root(std::numeric_limits<T>::max(), root_of_max)) {
+        std::cout << std::setw(10) << type << "  constexpr isqrt is wrong\n";
+        return false;
+    }
+    std::vector<T> values = random_values<T>(engine, count);
+    std::vector<T> edges = edge_values<T>();
+    values.insert(values.end(), edges.begin(), edges.end());
+    return compare(type, values);
+}
+
+//usage: benchmark-isqrt [count]
+//times the old digit loop against isqrt() on `count` random values of every width, and checks every result of the new one.
+int main(int argc, char* argv[]) {
+    const std::size_t count = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::mt19937_64 engine(20240601);
+    std::cout << std::setw(10) << "type" << std::setw(16) << "legacy [ns]" << std::setw(16) << "isqrt [ns]" << std::setw(10) << "speedup" << std::setw(8) << "wrong" << "\n";
+    bool correct = true;
+    correct &= run<std::uint8_t>("uint8", engine, count);
+    correct &= run<std::uint16_t>("uint16", engine, count);
+    correct &= run<std::int32_t>("int32", engine, count);
+    correct &= run<std::uint32_t>("uint32", engine, count);
+    correct &= run<std::int64_t>("int64", engine, count);
+    correct &= run<std::uint64_t>("uint64", engine, count);
+    correct &= run<__int128>("int128", engine, count);
+    correct &= run<unsigned __int128>("uint128", engine, count);
+    return correct ? 0 : 1;
+}
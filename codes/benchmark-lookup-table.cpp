@@ -0,0 +1,72 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "lookup-table.hpp"
+#include "table-functions.hpp"
+#include "benchmark.hpp"
+
+using UMJCUtil::Math::LookupTable;
+namespace CpuDispatch = UMJCUtil::CpuDispatch;
+
+//builds the table, checks every value it gives against the long double reference, and times it against the library function
+template <typename Func>
+bool run(const std::string& name, std::size_t count, std::mt19937_64& engine) {
+    LookupTable<Func>* built = nullptr;
+    double build = UMJCUtil::Bench::measure_seconds([&] { built = new LookupTable<Func>(); });
+    const LookupTable<Func>& table = *built;
+
+    std::uniform_real_distribution<double> argument(Func::LOWER, Func::UPPER);
+    std::vector<double> x(count), out(count);
+    for (auto& value : x) value = argument(engine);
+    //the printed grid and both ends of the domain too
+    for (int k = Func::FIRST; k <= Func::LAST; k++) x[static_cast<std::size_t>(k - Func::FIRST) % count] = Func::argument(k);
+    x[0] = Func::LOWER;
+    x[count - 1] = Func::UPPER;
+
+    double library = UMJCUtil::Bench::measure_seconds([&] {
+        for (std::size_t i = 0; i < count; i++) out[i] = Func::value(x[i]);
+        UMJCUtil::Bench::do_not_optimize(out.front());
+    }, 3);
+    double scalar = UMJCUtil::Bench::measure_seconds([&] {
+        for (std::size_t i = 0; i < count; i++) out[i] = table(x[i]);
+        UMJCUtil::Bench::do_not_optimize(out.front());
+    }, 3);
+    std::cout << std::setw(20) << name << std::setw(8) << table.pieces() << std::setw(12) << build
+        << std::setw(14) << count / library << std::setw(14) << count / scalar;
+
+    bool within = true;
+    long double observed = 0.0L;
+    for (CpuDispatch::Kernel kernel : { CpuDispatch::Kernel::scalar, CpuDispatch::Kernel::avx2, CpuDispatch::Kernel::avx512 }) {
+        CpuDispatch::set_kernel(kernel);
+        double batch = UMJCUtil::Bench::measure_seconds([&] {
+            table.evaluate(x, out);
+            UMJCUtil::Bench::do_not_optimize(out.front());
+        }, 3);
+        std::cout << std::setw(14) << (CpuDispatch::kernel() == kernel ? count / batch : 0.0);
+        for (std::size_t i = 0; i < count; i++) observed = std::max(observed, std::fabs(out[i] - Func::reference(x[i])));
+    }
+    CpuDispatch::set_kernel(CpuDispatch::supported_kernel());
+    within = observed <= table.max_error();
+    std::cout << std::setw(12) << table.max_error() << std::setw(12) << static_cast<double>(observed) << (within ? "" : "  EXCEEDED") << "\n";
+    delete built;
+    return within;
+}
+
+//usage: benchmark-lookup-table [values]
+//evaluates the functions behind the normal, log10 and sine tables at `values` random points; throughput in values / s, 0 for a kernel the CPU lacks.
+//exits with 1 if any value is further from the long double reference than the table's max_error().
+int main(int argc, char* argv[]) {
+    const std::size_t count = argc > 1 ? std::stoull(argv[1]) : 4'000'000;
+    std::mt19937_64 engine(20240601);
+    std::cout << std::setw(20) << "function" << std::setw(8) << "pieces" << std::setw(12) << "build [s]"
+        << std::setw(14) << "library" << std::setw(14) << "table" << std::setw(14) << "batch scalar" << std::setw(14) << "batch avx2" << std::setw(14) << "batch avx512"
+        << std::setw(12) << "bound" << std::setw(12) << "observed" << "\n";
+    bool within = true;
+    within &= run<UMJCUtil::Math::StandardNormalArea>("0.5 erf(z / sqrt 2)", count, engine);
+    within &= run<UMJCUtil::Math::CommonLogarithm>("log10(x)", count, engine);
+    within &= run<UMJCUtil::Math::QuarterSine>("sin(x pi / 2)", count, engine);
+    return within ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "primes.hpp"
+#include "benchmark.hpp"
+
+using UMJCUtil::Math::Primes;
+namespace CpuDispatch = UMJCUtil::CpuDispatch;
+
+template <typename T>
+void report(const std::string& candidates, const std::string& method, std::size_t count, double seconds, std::size_t found) {
+    std::cout << std::setw(10) << candidates << std::setw(22) << method << std::setw(14) << seconds << std::setw(18) << count / seconds << std::setw(10) << found << "\n";
+}
+
+//the scalar loop against is_prime_batch() with every kernel the CPU supports, single-threaded
+template <typename T>
+void compare(const std::string& candidates, const std::vector<T>& values) {
+    std::unique_ptr<bool[]> verdicts(new bool[values.size()]);
+    std::size_t found = 0;
+    double seconds = UMJCUtil::Bench::measure_seconds([&] {
+        found = 0;
+        for (T x : values) found += Primes<T>::is_prime(x);
+    }, 3);
+    report<T>(candidates, "is_prime loop", values.size(), seconds, found);
+    const std::pair<CpuDispatch::Kernel, const char*> kernels[] = {
+        { CpuDispatch::Kernel::scalar, "batch, scalar" },
+        { CpuDispatch::Kernel::avx2, "batch, avx2" },
+        { CpuDispatch::Kernel::avx512, "batch, avx512" },
+    };
+    for (auto [kernel, name] : kernels) {
+        if (kernel > CpuDispatch::supported_kernel()) continue;
+        CpuDispatch::set_kernel(kernel);
+        seconds = UMJCUtil::Bench::measure_seconds([&] {
+            Primes<T>::is_prime_batch(values, std::span<bool>(verdicts.get(), values.size()), 1);
+            UMJCUtil::Bench::do_not_optimize(verdicts[0]);
+        }, 3);
+        found = 0;
+        for (std::size_t i = 0; i < values.size(); i++) found += verdicts[i];
+        report<T>(candidates, name, values.size(), seconds, found);
+    }
+    CpuDispatch::set_kernel(CpuDispatch::supported_kernel());
+}
+
+//usage: benchmark-primality [count]
+//tests `count` random odd 32-bit and 64-bit candidates; the prime counts of every row must agree.
+int main(int argc, char* argv[]) {
+    const std::size_t count = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::mt19937_64 engine(20240601);
+    std::vector<std::uint32_t> small(count);
+    for (auto& x : small) x = static_cast<std::uint32_t>(engine()) | 1;
+    std::vector<std::uint64_t> large(count);
+    for (auto& x : large) x = engine() | 1;
+    std::cout << std::setw(10) << "bits" << std::setw(22) << "method" << std::setw(14) << "total [s]" << std::setw(18) << "candidates / s" << std::setw(10) << "primes" << "\n";
+    compare("32", small);
+    compare("64", large);
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "primes.hpp"
+#include "benchmark.hpp"
+
+//ensure_primes_up_to as it was before the segmented sieve: every odd candidate is trial-divided by every prime found so far.
+std::vector<std::uint64_t> legacy_primes_up_to(std::uint64_t n) {
+    std::vector<std::uint64_t> prefound = { 2, 3, 5, 7 };
+    for (std::uint64_t i = 9; i <= n; i += 2) {
+        bool i_is_prime = true;
+        for (auto p : prefound) {
+            if (i % p == 0) {
+                i_is_prime = false;
+                break;
+            }
+        }
+        if (i_is_prime) prefound.push_back(i);
+    }
+    return prefound;
+}
+
+//usage: benchmark-sieve [legacy_limit]
+//legacy trial division is O(n pi(n)), so by default it only runs up to 10^6.
+int main(int argc, char* argv[]) {
+    const std::uint64_t legacy_limit = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::cout << std::setw(12) << "n" << std::setw(14) << "pi(n)" << std::setw(14) << "legacy [s]" << std::setw(14) << "sieve [s]" << std::setw(12) << "speedup" << "\n";
+    for (std::uint64_t n : { std::uint64_t(1'000'000), std::uint64_t(100'000'000), std::uint64_t(1'000'000'000) }) {
+        std::size_t count = 0;
+        double sieve_time = UMJCUtil::Bench::measure_seconds([&] {
+            auto primes = UMJCUtil::Math::SegmentedSieve::primes_up_to(n);
+            count = primes.size();
+            UMJCUtil::Bench::do_not_optimize(primes.data());
+        });
+        std::cout << std::setw(12) << n << std::setw(14) << count;
+        if (n <= legacy_limit) {
+            double legacy_time = UMJCUtil::Bench::measure_seconds([&] {
+                auto primes = legacy_primes_up_to(n);
+                UMJCUtil::Bench::do_not_optimize(primes.data());
+            });
+            std::cout << std::setw(14) << legacy_time << std::setw(14) << sieve_time << std::setw(11) << legacy_time / sieve_time << "x\n";
+        }
+        else {
+            std::cout << std::setw(14) << "-" << std::setw(14) << sieve_time << std::setw(12) << "-" << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,241 @@
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "primes.hpp"
+#include "isqrt.hpp"
+#include "lookup-table.hpp"
+#include "table-engine.hpp"
+#include "table-functions.hpp"
+#include "quantile-solver.hpp"
+#include "factorial-table.hpp"
+#include "constants.hpp"
+#include "linear-sieve.hpp"
+#include "benchmark.hpp"
+
+using UMJCUtil::Bench::Suite;
+using UMJCUtil::Bench::do_not_optimize;
+
+namespace {
+    //count values of T, each a random number of bits up to `bits` wide
+    template <typename T>
+    std::vector<T> random_values(std::mt19937_64& engine, std::size_t count, int bits) {
+        std::vector<T> rtrn(count);
+        for (auto& x : rtrn) x = static_cast<T>(engine() >> (64 - bits));
+        return rtrn;
+    }
+
+    std::uint64_t random_prime(std::mt19937_64& engine, int bits) {
+        while (true) {
+            std::uint64_t candidate = (engine() >> (64 - bits)) | (std::uint64_t(1) << (bits - 1)) | 1;
+            if (UMJCUtil::Math::MillerRabin::is_prime(candidate)) return candidate;
+        }
+    }
+
+    template <typename T>
+    void add_is_prime(Suite& suite, std::mt19937_64& engine, const std::string& type, int bits) {
+        auto values = std::make_shared<std::vector<T>>(random_values<T>(engine, 100'000, bits));
+        suite.add("is_prime<" + type + ">/" + std::to_string(bits) + "bit", values->size(), [values] {
+            std::size_t found = 0;
+            for (T x : *values) found += UMJCUtil::Math::Primes<T>::is_prime(x);
+            do_not_optimize(found);
+        });
+        suite.add("is_prime_batch<" + type + ">/" + std::to_string(bits) + "bit", values->size(), [values] {
+            do_not_optimize(UMJCUtil::Math::Primes<T>::count_primes_in(*values));
+        });
+    }
+
+    template <typename T>
+    void add_isqrt(Suite& suite, std::mt19937_64& engine, const std::string& type) {
+        auto values = std::make_shared<std::vector<T>>(random_values<T>(engine, 1'000'000, std::numeric_limits<T>::digits < 64 ? std::numeric_limits<T>::digits : 64));
+        suite.add("isqrt<" + type + ">", values->size(), [values] {
+            T sum = 0;
+            for (T x : *values) sum += UMJCUtil::Math::isqrt(x);
+            do_not_optimize(sum);
+        });
+    }
+
+    template <typename Func>
+    UMJCUtil::Tables::Table function_table() {
+        UMJCUtil::Tables::Table rtrn;
+        rtrn.rows = static_cast<std::size_t>(Func::LAST - Func::FIRST + 1) / 10;
+        rtrn.columns = 10;
+        rtrn.row_label = [](std::size_t i) { return std::to_string(i); };
+        rtrn.cell = [](std::size_t i, std::size_t j) { return Func::value(Func::argument(static_cast<int>(i * 10 + j) + Func::FIRST)); };
+        rtrn.rule_every = 10;
+        return rtrn;
+    }
+
+    template <typename Func>
+    void add_lookup_table(Suite& suite, std::mt19937_64& engine, const std::string& name) {
+        std::uniform_real_distribution<double> argument(Func::LOWER, Func::UPPER);
+        auto values = std::make_shared<std::vector<double>>(1'000'000);
+        for (auto& x : *values) x = argument(engine);
+        auto out = std::make_shared<std::vector<double>>(values->size());
+        suite.add("lookup_table/" + name, values->size(), [values, out] {
+            UMJCUtil::Math::LookupTable<Func>::shared().evaluate(*values, *out);
+            do_not_optimize(out->front());
+        });
+    }
+
+    void add_kernels(Suite& suite) {
+        std::mt19937_64 engine(20240601);
+        add_is_prime<std::uint32_t>(suite, engine, "uint32", 16);
+        add_is_prime<std::uint32_t>(suite, engine, "uint32", 32);
+        add_is_prime<std::uint64_t>(suite, engine, "uint64", 48);
+        add_is_prime<std::uint64_t>(suite, engine, "uint64", 64);
+        add_is_prime<std::int64_t>(suite, engine, "int64", 62);
+
+        auto small = std::make_shared<std::vector<std::int64_t>>(random_values<std::int64_t>(engine, 1'000'000, 16));
+        suite.add("constexpr_is_prime<int64>/16bit", small->size(), [small] {
+            std::size_t found = 0;
+            for (std::int64_t x : *small) found += UMJCUtil::Math::is_prime(x);
+            do_not_optimize(found);
+        });
+
+        for (std::uint64_t n : { std::uint64_t(10'000'000), std::uint64_t(1'000'000'000), std::uint64_t(100'000'000'000) }) {
+            suite.add("pi<uint64>/" + std::to_string(n), 1, [n] { do_not_optimize(UMJCUtil::Math::Primes<std::uint64_t>::pi(n)); });
+        }
+
+        auto semiprimes = std::make_shared<std::vector<std::uint64_t>>(1000);
+        for (auto& n : *semiprimes) n = random_prime(engine, 31) * random_prime(engine, 31);
+        suite.add("factor<uint64>/62bit_semiprime", semiprimes->size(), [semiprimes] {
+            std::size_t factors = 0;
+            for (auto n : *semiprimes) factors += UMJCUtil::Math::Primes<std::uint64_t>::factor(n).size();
+            do_not_optimize(factors);
+        });
+        auto composites = std::make_shared<std::vector<std::uint32_t>>(random_values<std::uint32_t>(engine, 10'000, 32));
+        suite.add("factor<uint32>/32bit", composites->size(), [composites] {
+            std::size_t factors = 0;
+            for (auto n : *composites) factors += UMJCUtil::Math::Primes<std::uint32_t>::factor(n).size();
+            do_not_optimize(factors);
+        });
+
+        suite.add("linear_sieve/10000000", 10'000'000, [] {
+            UMJCUtil::Math::LinearSieve sieve(10'000'000);
+            do_not_optimize(sieve.smallest_prime_factor(9'999'999));
+        });
+        auto linear_sieve = std::make_shared<UMJCUtil::Math::LinearSieve>(10'000'000);
+        suite.add("arithmetic_functions/10000000", 10'000'000, [linear_sieve] {
+            do_not_optimize(linear_sieve->arithmetic_functions(1, 10'000'000).totient.back());
+        });
+        suite.add("segmented_arithmetic_functions/10000000", 10'000'000, [] {
+            do_not_optimize(UMJCUtil::Math::LinearSieve::segmented_arithmetic_functions(1, 10'000'000).totient.back());
+        });
+        suite.add("segmented_arithmetic_functions/near_2^32", 1'000'000, [] {
+            do_not_optimize(UMJCUtil::Math::LinearSieve::segmented_arithmetic_functions(4'293'967'296u, 4'294'967'295u).totient.back());
+        });
+
+        add_isqrt<std::uint32_t>(suite, engine, "uint32");
+        add_isqrt<std::uint64_t>(suite, engine, "uint64");
+        add_isqrt<std::int64_t>(suite, engine, "int64");
+
+        add_lookup_table<UMJCUtil::Math::StandardNormalArea>(suite, engine, "normal");
+        add_lookup_table<UMJCUtil::Math::CommonLogarithm>(suite, engine, "log10");
+        add_lookup_table<UMJCUtil::Math::QuarterSine>(suite, engine, "sine");
+
+        //what the generators do, without the process start-up: one render of each table into memory
+        suite.add("generate/normal", 1, [] {
+            std::ostringstream out;
+            UMJCUtil::Tables::render(out, function_table<UMJCUtil::Math::StandardNormalArea>());
+            do_not_optimize(out.tellp());
+        });
+        suite.add("generate/log10", 1, [] {
+            std::ostringstream out;
+            UMJCUtil::Tables::render(out, function_table<UMJCUtil::Math::CommonLogarithm>());
+            do_not_optimize(out.tellp());
+        });
+        suite.add("generate/sine", 1, [] {
+            std::ostringstream out;
+            UMJCUtil::Tables::render(out, function_table<UMJCUtil::Math::QuarterSine>());
+            do_not_optimize(out.tellp());
+        });
+        //a fresh solver each time, so every quantile is solved rather than found in the cache
+        suite.add("generate/f_30x30", 1, [] {
+            UMJCUtil::Math::QuantileSolver solver;
+            UMJCUtil::Tables::Table table;
+            table.rows = 30;
+            table.columns = 30;
+            table.row_label = [](std::size_t i) { return std::to_string(i + 1); };
+            table.chained_cell = [&solver](std::size_t i, std::size_t j, std::span<const double> above) { return solver.fisher_f(static_cast<double>(j + 1), static_cast<double>(i + 1), 0.05, above); };
+            std::ostringstream out;
+            UMJCUtil::Tables::render(out, table);
+            do_not_optimize(out.tellp());
+        });
+        suite.add("generate/factorial_1000", 1, [] {
+            std::ostringstream out;
+            UMJCUtil::Tables::FactorialRows().write(out, 1, 1000);
+            do_not_optimize(out.tellp());
+        });
+        suite.add("constants/pi_100000", 1, [] {
+            do_not_optimize(mpz_size(UMJCUtil::Math::Constants::decimal(UMJCUtil::Math::Constants::pi, 100'000).get_mpz_t()));
+        });
+    }
+}
+
+//usage: benchmark-suite [--filter text] [--repeats r] [--save baseline.json] [--compare baseline.json] [--threshold fraction]
+//times every kernel whose name contains `text` (all by default) in ns per operation, the fastest of r runs (5 by default).
+//--save writes the results as a JSON baseline. --compare checks them against one and exits with 1 if any kernel
+//takes more than (1 + fraction) times its baseline (0.20 by default, above the run-to-run noise of a shared machine).
+//baselines are only comparable on the same machine and build flags.
+//exits with 2, before timing anything, on a bad command line or a baseline that cannot be read, and with 2 as well if --save cannot write.
+//build: g++ -std=gnu++20 -O2 benchmark-suite.cpp -lgmpxx -lgmp
+int main(int argc, char* argv[]) {
+    std::string filter, save_path, compare_path;
+    int repeats = 5;
+    double threshold = 0.20;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "missing the value of " << option << "\n";
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (option == "--filter") filter = value;
+        else if (option == "--repeats") repeats = std::stoi(value);
+        else if (option == "--save") save_path = value;
+        else if (option == "--compare") compare_path = value;
+        else if (option == "--threshold") threshold = std::stod(value);
+        else {
+            std::cerr << "unknown option " << option << "\n";
+            return 2;
+        }
+    }
+
+    //the baseline is checked before minutes of timing, not after
+    std::map<std::string, double> baseline;
+    if (!compare_path.empty()) {
+        try {
+            baseline = Suite::read_json(compare_path);
+        }
+        catch (const std::runtime_error& error) {
+            std::cerr << error.what() << "\n";
+            return 2;
+        }
+    }
+
+    Suite suite;
+    add_kernels(suite);
+    std::vector<Suite::Result> results = suite.run(filter, repeats, compare_path.empty() ? &std::cout : nullptr);
+    if (!save_path.empty()) {
+        std::ofstream out(save_path);
+        Suite::write_json(out, results);
+        if (!out) {
+            std::cerr << "cannot write " << save_path << "\n";
+            return 2;
+        }
+    }
+    if (!compare_path.empty()) {
+        std::size_t regressed = Suite::compare(std::cout, results, baseline, threshold);
+        std::cout << regressed << " of " << results.size() << " kernels regressed by more than " << threshold * 100.0 << "%\n";
+        return regressed == 0 ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+#ifndef UMJCUTIL_BENCH_BENCHMARK_HPP
+#define UMJCUTIL_BENCH_BENCHMARK_HPP
+
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace UMJCUtil {
+    namespace Bench {
+        //keeps the optimizer from throwing away a result that nothing else reads.
+        template <typename T>
+        inline void do_not_optimize(const T& value) {
+            asm volatile("" : : "r,m"(value) : "memory");
+        }
+
+        /**
+         * @brief wall-clock seconds of the fastest of `repeats` runs of func
+        */
+        template <typename Func>
+        double measure_seconds(Func&& func, int repeats = 1) {
+            double best = std::numeric_limits<double>::infinity();
+            for (int i = 0; i < repeats; i++) {
+                auto begin = std::chrono::steady_clock::now();
+                func();
+                auto end = std::chrono::steady_clock::now();
+                best = std::min(best, std::chrono::duration<double>(end - begin).count());
+            }
+            return best;
+        }
+
+        /**
+         * @brief named kernels timed in ns per operation, saved as JSON baselines and compared against them
+         * a baseline file is
+         *   {"benchmarks": [
+         *     {"name": "...", "ns_per_op": ...},
+         *     ...
+         *   ]}
+         * compare() counts a kernel as regressed when it takes more than (1 + threshold) times its baseline.
+        */
+        class Suite {
+        public:
+            struct Result {
+                std::string name;
+                double ns_per_op;
+            };
+
+            //a timed run repeats a kernel until it takes at least this long, so short kernels are not lost in timer and scheduling noise
+            static constexpr double MIN_RUN_SECONDS = 0.1;
+
+            //func does `operations` operations per call; it is timed by the fastest of the repeats
+            void add(std::string name, std::size_t operations, std::function<void()> func) {
+                cases.push_back({ std::move(name), operations, std::move(func) });
+            }
+
+            //the kernels whose name contains filter
+            std::vector<Result> run(const std::string& filter = "", int repeats = 5, std::ostream* progress = nullptr) const {
+                std::vector<Result> rtrn;
+                for (const auto& kernel : cases) {
+                    if (kernel.name.find(filter) == std::string::npos) continue;
+                    //the first call warms caches and lazily built tables, and sets how many calls make up one timed run
+                    double once = measure_seconds(kernel.func);
+                    std::size_t calls = once >= MIN_RUN_SECONDS ? 1 : static_cast<std::size_t>(MIN_RUN_SECONDS / std::max(once, 1e-9)) + 1;
+                    double seconds = measure_seconds([&] {
+                        for (std::size_t i = 0; i < calls; i++) kernel.func();
+                    }, repeats);
+                    rtrn.push_back({ kernel.name, seconds * 1e9 / static_cast<double>(calls * kernel.operations) });
+                    if (progress != nullptr) *progress << std::setw(40) << std::left << rtrn.back().name << std::right << std::setw(14) << rtrn.back().ns_per_op << " ns/op\n" << std::flush;
+                }
+                return rtrn;
+            }
+
+            static void write_json(std::ostream& out, const std::vector<Result>& results) {
+                out << "{\"benchmarks\": [\n";
+                for (std::size_t i = 0; i < results.size(); i++) {
+                    out << "  {\"name\": \"" << results[i].name << "\", \"ns_per_op\": " << std::setprecision(17) << results[i].ns_per_op << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+                }
+                out << "]}\n";
+            }
+
+            //name -> ns_per_op of a file written by write_json(); names may not contain quotes. throws std::runtime_error for a missing or damaged file
+            static std::map<std::string, double> read_json(const std::string& path) {
+                std::ifstream in(path);
+                if (!in) throw std::runtime_error("cannot open the baseline " + path);
+                std::stringstream text;
+                text << in.rdbuf();
+                std::string json = text.str();
+                std::map<std::string, double> rtrn;
+                const std::string name_key = "\"name\": \"", time_key = "\"ns_per_op\": ";
+                if (json.find("{\"benchmarks\": [") != 0) throw std::runtime_error("damaged baseline " + path);
+                for (std::size_t at = json.find(name_key); at != std::string::npos; at = json.find(name_key, at)) {
+                    std::size_t name_begin = at + name_key.size(), name_end = json.find('"', name_begin);
+                    std::size_t time_at = name_end == std::string::npos ? name_end : json.find(time_key, name_end);
+                    if (time_at == std::string::npos) throw std::runtime_error("damaged baseline " + path);
+                    const char* time_begin = json.c_str() + time_at + time_key.size();
+                    char* time_end = nullptr;
+                    double ns_per_op = std::strtod(time_begin, &time_end);
+                    if (time_end == time_begin || !(ns_per_op > 0.0)) throw std::runtime_error("damaged baseline " + path);
+                    rtrn[json.substr(name_begin, name_end - name_begin)] = ns_per_op;
+                    at = time_at;
+                }
+                if (rtrn.empty()) throw std::runtime_error("damaged baseline " + path);
+                return rtrn;
+            }
+
+            //prints every result against its baseline; returns how many regressed. kernels missing from the baseline are only listed.
+            static std::size_t compare(std::ostream& out, const std::vector<Result>& results, const std::map<std::string, double>& baseline, double threshold) {
+                std::size_t rtrn = 0;
+                out << std::setw(40) << std::left << "kernel" << std::right << std::setw(14) << "baseline" << std::setw(14) << "now" << std::setw(10) << "ratio" << "\n";
+                for (const auto& result : results) {
+                    auto found = baseline.find(result.name);
+                    out << std::setw(40) << std::left << result.name << std::right;
+                    if (found == baseline.end()) {
+                        out << std::setw(14) << "-" << std::setw(14) << result.ns_per_op << std::setw(10) << "-" << "  new\n";
+                        continue;
+                    }
+                    double ratio = result.ns_per_op / found->second;
+                    bool regressed = ratio > 1.0 + threshold;
+                    rtrn += regressed;
+                    out << std::setw(14) << found->second << std::setw(14) << result.ns_per_op << std::setw(10) << std::setprecision(3) << ratio << std::setprecision(6) << (regressed ? "  REGRESSED" : "") << "\n";
+                }
+                return rtrn;
+            }
+
+        private:
+            struct Case {
+                std::string name;
+                std::size_t operations;
+                std::function<void()> func;
+            };
+            std::vector<Case> cases;
+        };
+    }
+}
+
+#endif
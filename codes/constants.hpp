@@ -0,0 +1,356 @@
+#ifndef UMJCUTIL_MATH_CONSTANTS_HPP
+#define UMJCUTIL_MATH_CONSTANTS_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <gmpxx.h>
+#include "primes.hpp"
+#include "thread-pool.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief the sum of terms [first, last) of a series as one exact fraction, by binary splitting
+         * Series gives Range leaf(k), the fraction of term k alone, and merge(left, right), which leaves in left the fraction of
+         * left's terms followed by right's. halving the range keeps the operands of every multiplication about equal in size,
+         * so GMP's FFT multiplication does the bulk of the work.
+        */
+        template <typename Series>
+        typename Series::Range binary_split(const Series& series, std::uint64_t first, std::uint64_t last) {
+            if (last - first == 1) return series.leaf(first);
+            std::uint64_t middle = first + (last - first) / 2;
+            typename Series::Range rtrn = binary_split(series, first, middle);
+            typename Series::Range right = binary_split(series, middle, last);
+            Series::merge(rtrn, right);
+            return rtrn;
+        }
+
+        /**
+         * @brief binary_split() of terms [0, terms) with the product tree spread over the shared ThreadPool
+         * the terms are cut into a few chunks per thread, each split on its own, and the chunks are merged pairwise a level at a time,
+         * the merges of a level in parallel. only the last few merges, a small part of the work, run on fewer threads than there are.
+         * @param concurrency: at most this many threads work on the call, 0 for the pool's setting
+        */
+        template <typename Series>
+        typename Series::Range binary_split_parallel(const Series& series, std::uint64_t terms, std::size_t concurrency = 0) {
+            if (terms == 0) throw std::invalid_argument("a series needs at least one term");
+            ThreadPool& pool = ThreadPool::shared();
+            std::size_t threads = concurrency == 0 ? pool.concurrency() : std::min(concurrency, pool.concurrency());
+            std::size_t chunks = static_cast<std::size_t>(std::min<std::uint64_t>(terms, threads <= 1 ? 1 : std::bit_ceil(threads) * 4));
+            std::vector<typename Series::Range> ranges(chunks);
+            pool.parallel_for(chunks, [&](std::size_t c) {
+                ranges[c] = binary_split(series, terms * c / chunks, terms * (c + 1) / chunks);
+            }, concurrency);
+            for (std::size_t width = 1; width < chunks; width *= 2) {
+                pool.parallel_for((chunks + 2 * width - 1) / (2 * width), [&](std::size_t i) {
+                    std::size_t left = 2 * width * i, right = left + width;
+                    if (right < chunks) Series::merge(ranges[left], ranges[right]);
+                }, concurrency);
+            }
+            return std::move(ranges[0]);
+        }
+
+        /**
+         * @brief S = sum over k of a(k) / b(k) * p(0) ... p(k) / (q(0) ... q(k)), all of them integers (Haible and Papanikolaou)
+         * coefficients(k, a, b, p, q) sets the four for term k.
+        */
+        template <typename Coefficients>
+        class HypergeometricSeries {
+        public:
+            //the terms of a range sum to t / (b q), b and q being the products of b(k) and q(k) over the range
+            struct Range {
+                mpz_class p, q, b, t;
+            };
+
+            explicit HypergeometricSeries(Coefficients coefficients) : coefficients(std::move(coefficients)) {}
+
+            Range leaf(std::uint64_t k) const {
+                Range rtrn;
+                mpz_class a;
+                coefficients(k, a, rtrn.b, rtrn.p, rtrn.q);
+                rtrn.t = a * rtrn.p;
+                return rtrn;
+            }
+            static void merge(Range& left, Range& right) {
+                //t = b_r q_r t_l + b_l p_l t_r
+                left.t *= right.q;
+                left.t *= right.b;
+                right.t *= left.p;
+                right.t *= left.b;
+                left.t += right.t;
+                left.p *= right.p;
+                left.q *= right.q;
+                left.b *= right.b;
+            }
+
+            //floor(S * 2^bits) for the first `terms` terms, S > 0
+            mpz_class fixed_point(std::uint64_t terms, std::size_t bits, std::size_t concurrency = 0) const {
+                Range sum = binary_split_parallel(*this, terms, concurrency);
+                mpz_class rtrn = sum.t << bits;
+                mpz_class divisor = sum.b * sum.q;
+                mpz_fdiv_q(rtrn.get_mpz_t(), rtrn.get_mpz_t(), divisor.get_mpz_t());
+                return rtrn;
+            }
+
+        private:
+            Coefficients coefficients;
+        };
+
+        /**
+         * @brief fixed-point approximations of mathematical constants: value(bits) is v * 2^bits, off by a few units at most
+         * the series are summed exactly by binary splitting and divided once at the end; see decimal() for the digits.
+         * @param concurrency: at most this many threads of the shared ThreadPool work on the call, 0 for the pool's setting
+        */
+        class Constants {
+        public:
+            //every value() below is within 2^ERROR_BITS units of the last place
+            static constexpr std::size_t ERROR_BITS = 16;
+
+            /**
+             * @brief floor(v * 10^digits) for the constant whose value(bits, concurrency) is given
+             * computes with GUARD_BITS bits beyond the digits asked for, and again with twice as many while the error could
+             * still move the last digit, so the digits are the truncated ones whatever the rounding of the value.
+            */
+            template <typename Value>
+            static mpz_class decimal(Value&& value, std::size_t digits, std::size_t concurrency = 0) {
+                mpz_class power;
+                mpz_ui_pow_ui(power.get_mpz_t(), 10, digits);
+                for (std::size_t guard = GUARD_BITS;; guard *= 2) {
+                    std::size_t bits = static_cast<std::size_t>(std::ceil(static_cast<double>(digits) * std::log2(10.0))) + guard;
+                    mpz_class scaled = value(bits, concurrency) * power;
+                    mpz_class rtrn = scaled >> bits;
+                    mpz_class fraction = scaled - (rtrn << bits);
+                    //the error of scaled is below 10^digits * 2^ERROR_BITS <= 2^(bits - guard + ERROR_BITS)
+                    mpz_class margin = mpz_class(1) << (bits - guard + ERROR_BITS);
+                    if ((fraction >= margin && fraction + margin <= mpz_class(1) << bits) || guard >= MAX_GUARD_BITS) return rtrn;
+                }
+            }
+            //floor(root(n, k) * 10^digits), exact
+            static mpz_class root_decimal(unsigned long n, unsigned long k, std::size_t digits) {
+                mpz_class rtrn;
+                mpz_ui_pow_ui(rtrn.get_mpz_t(), 10, digits * k);
+                rtrn *= n;
+                mpz_root(rtrn.get_mpz_t(), rtrn.get_mpz_t(), k);
+                return rtrn;
+            }
+
+            //Chudnovsky: 1 / pi = 12 / 640320^(3/2) sum (-1)^k (6k)! (13591409 + 545140134 k) / ((3k)! (k!)^3 640320^(3k)), about 14 digits a term
+            static mpz_class pi(std::size_t bits, std::size_t concurrency = 0) {
+                HypergeometricSeries series([](std::uint64_t k, mpz_class& a, mpz_class& b, mpz_class& p, mpz_class& q) {
+                    a = 545140134;
+                    a *= k;
+                    a += 13591409;
+                    b = 1;
+                    if (k == 0) {
+                        p = 1;
+                        q = 1;
+                        return;
+                    }
+                    p = 6 * k - 5;
+                    p *= 2 * k - 1;
+                    p *= 6 * k - 1;
+                    p = -p;
+                    q = k;
+                    q *= k;
+                    q *= k;
+                    q *= 10939058860032000ul; //640320^3 / 24
+                });
+                auto sum = binary_split_parallel(series, static_cast<std::uint64_t>(static_cast<double>(bits) / 47.11) + 2, concurrency);
+                //pi = 426880 sqrt(10005) q / t
+                mpz_class rtrn = mpz_class(10005) << (2 * bits);
+                mpz_sqrt(rtrn.get_mpz_t(), rtrn.get_mpz_t());
+                rtrn *= 426880;
+                rtrn *= sum.q;
+                mpz_fdiv_q(rtrn.get_mpz_t(), rtrn.get_mpz_t(), sum.t.get_mpz_t());
+                return rtrn;
+            }
+
+            //sum 1 / k!
+            static mpz_class e(std::size_t bits, std::size_t concurrency = 0) {
+                HypergeometricSeries series([](std::uint64_t k, mpz_class& a, mpz_class& b, mpz_class& p, mpz_class& q) {
+                    a = 1;
+                    b = 1;
+                    p = 1;
+                    q = k == 0 ? 1 : k;
+                });
+                return series.fixed_point(terms_for(0.0, bits), bits, concurrency);
+            }
+
+            //ln 2 = 18 acoth(26) - 2 acoth(4801) + 8 acoth(8749)
+            static mpz_class ln2(std::size_t bits, std::size_t concurrency = 0) {
+                return 18 * acoth(26, bits, concurrency) - 2 * acoth(4801, bits, concurrency) + 8 * acoth(8749, bits, concurrency);
+            }
+
+            /**
+             * @brief Euler-Mascheroni constant by Brent and McMillan: gamma = A / B - ln n, within pi e^(-4n)
+             * A = sum (n^k / k!)^2 H_k, B = sum (n^k / k!)^2, H_k the kth harmonic number. n is a power of 2, so that ln n is a multiple of ln 2.
+            */
+            static mpz_class euler_gamma(std::size_t bits, std::size_t concurrency = 0) {
+                std::size_t log2_n = static_cast<std::size_t>(std::bit_width(static_cast<std::uint64_t>(std::ceil(static_cast<double>(bits + 8) * std::log(2.0) / 4.0))));
+                HarmonicSeries series(std::uint64_t(1) << log2_n);
+                //(n^k / k!)^2 is e^(-2n) at k = 3.5911 n, so terms past that are below 2^-bits of B
+                auto sum = binary_split_parallel(series, static_cast<std::uint64_t>(3.5912 * static_cast<double>(std::uint64_t(1) << log2_n)) + 16, concurrency);
+                //A = v / (q d), B = 1 + t / q, the term k = 0 being 1
+                mpz_class rtrn = sum.v << bits;
+                mpz_class divisor = sum.d * (sum.q + sum.t);
+                mpz_fdiv_q(rtrn.get_mpz_t(), rtrn.get_mpz_t(), divisor.get_mpz_t());
+                return rtrn - log2_n * ln2(bits, concurrency);
+            }
+
+            //Amdeberhan and Zeilberger: zeta(3) = 1/64 sum (-1)^k (k!)^10 (205k^2 + 250k + 77) / ((2k + 1)!)^5, about 3 digits a term
+            static mpz_class zeta3(std::size_t bits, std::size_t concurrency = 0) {
+                HypergeometricSeries series([](std::uint64_t k, mpz_class& a, mpz_class& b, mpz_class& p, mpz_class& q) {
+                    a = 205 * k * k + 250 * k + 77;
+                    b = 1;
+                    if (k == 0) {
+                        p = 1;
+                        q = 1;
+                        return;
+                    }
+                    mpz_ui_pow_ui(p.get_mpz_t(), k, 5);
+                    p = -p;
+                    mpz_ui_pow_ui(q.get_mpz_t(), 2 * k + 1, 5);
+                    q *= 32;
+                });
+                return series.fixed_point(bits / 10 + 2, bits, concurrency) >> 6;
+            }
+
+            /**
+             * @brief e^(x / 2^bits) for 0 <= x < 2^bits, by bit-burst
+             * x is cut into pieces of 8, 8, 16, 32, ... bits, and exp of each is a series in a rational with a short numerator;
+             * the piece starting at bit `low` is below 2^-low, so its terms shrink that much faster. the pieces' exponentials multiply together.
+            */
+            static mpz_class exp(const mpz_class& x, std::size_t bits, std::size_t concurrency = 0) {
+                if (x < 0 || x >= mpz_class(1) << bits) throw std::domain_error("exp() takes arguments in [0, 1)");
+                mpz_class rtrn = mpz_class(1) << bits;
+                for (std::size_t low = 0, high = 8; low < bits; low = high, high = std::min(bits, 2 * high)) {
+                    //piece = the bits of x worth 2^-(low + 1) ... 2^-high, over 2^high
+                    mpz_class piece = (x >> (bits - high)) - ((x >> (bits - low)) << (high - low));
+                    if (piece == 0) continue;
+                    HypergeometricSeries series([&piece, high](std::uint64_t k, mpz_class& a, mpz_class& b, mpz_class& p, mpz_class& q) {
+                        a = 1;
+                        b = 1;
+                        p = k == 0 ? mpz_class(1) : piece;
+                        q = k == 0 ? mpz_class(1) : mpz_class(k) << high;
+                    });
+                    rtrn *= series.fixed_point(terms_for(static_cast<double>(low), bits), bits, concurrency);
+                    rtrn >>= bits;
+                }
+                return rtrn;
+            }
+
+            //the omega constant, W(1): the root of x = e^-x, by Newton's method at doubling precision
+            static mpz_class omega(std::size_t bits, std::size_t concurrency = 0) {
+                std::vector<std::size_t> precisions = { bits + 8 };
+                while (precisions.back() > 64) precisions.push_back(precisions.back() / 2 + 8);
+                //0.56714 32904 09783 87299... to 53 bits
+                mpz_class rtrn = static_cast<unsigned long>(0x122609AF8E9657ul);
+                std::size_t at = 53;
+                for (auto it = precisions.rbegin(); it != precisions.rend(); ++it) {
+                    rtrn = at < *it ? mpz_class(rtrn << (*it - at)) : mpz_class(rtrn >> (at - *it));
+                    at = *it;
+                    //x <- e^-x (1 + x) / (1 + e^-x)
+                    mpz_class one = mpz_class(1) << at;
+                    mpz_class inverse = one << at;
+                    mpz_class growth = exp(rtrn, at, concurrency);
+                    mpz_fdiv_q(inverse.get_mpz_t(), inverse.get_mpz_t(), growth.get_mpz_t());
+                    mpz_class divisor = one + inverse;
+                    rtrn = inverse * (one + rtrn);
+                    mpz_fdiv_q(rtrn.get_mpz_t(), rtrn.get_mpz_t(), divisor.get_mpz_t());
+                }
+                return rtrn >> 8;
+            }
+
+            //the prime constant, sum of 2^-p over the primes: its binary digits mark the primes, so the value is exact but for the truncation
+            static mpz_class prime_constant(std::size_t bits, std::size_t = 0) {
+                mpz_class rtrn = 0;
+                for (std::uint64_t p : Primes<std::uint64_t>::primes_between(2, bits)) mpz_setbit(rtrn.get_mpz_t(), bits - p);
+                return rtrn;
+            }
+
+        private:
+            static constexpr std::size_t GUARD_BITS = 64;
+            static constexpr std::size_t MAX_GUARD_BITS = 4096;
+
+            //the terms of sum r^k / k! (r <= 2^-log2_ratio) up to the first below 2^-(bits + 8)
+            static std::uint64_t terms_for(double log2_ratio, std::size_t bits) {
+                double remaining = static_cast<double>(bits + 8);
+                std::uint64_t rtrn = 1;
+                for (; remaining > 0; rtrn++) remaining -= log2_ratio + std::log2(static_cast<double>(rtrn));
+                return rtrn;
+            }
+
+            //acoth(x) = sum 1 / ((2k + 1) x^(2k + 1))
+            static mpz_class acoth(unsigned long x, std::size_t bits, std::size_t concurrency) {
+                HypergeometricSeries series([x](std::uint64_t k, mpz_class& a, mpz_class& b, mpz_class& p, mpz_class& q) {
+                    a = 1;
+                    b = 2 * k + 1;
+                    p = 1;
+                    q = x;
+                    if (k != 0) q *= x;
+                });
+                return series.fixed_point(static_cast<std::uint64_t>(static_cast<double>(bits) / (2.0 * std::log2(static_cast<double>(x)))) + 2, bits, concurrency);
+            }
+
+            /**
+             * @brief terms k = 1, 2, ... of Brent and McMillan's sums, u_k = (n^k / k!)^2 and u_k H_k
+             * a range's u_k (relative to the term before it) sum to t / q and its u_k H_k to v / (q d), with c / d the sum of 1 / k over it.
+            */
+            class HarmonicSeries {
+            public:
+                struct Range {
+                    mpz_class p, q, c, d, t, v;
+                };
+
+                explicit HarmonicSeries(std::uint64_t n) : n(n) {}
+
+                Range leaf(std::uint64_t index) const {
+                    std::uint64_t k = index + 1;
+                    Range rtrn;
+                    rtrn.p = n;
+                    rtrn.p *= n;
+                    rtrn.q = k;
+                    rtrn.q *= k;
+                    rtrn.c = 1;
+                    rtrn.d = k;
+                    rtrn.t = rtrn.p;
+                    rtrn.v = rtrn.p;
+                    return rtrn;
+                }
+                static void merge(Range& left, Range& right) {
+                    //v = v_l q_r d_r + p_l c_l t_r d_r + p_l v_r d_l
+                    left.v *= right.q;
+                    left.v *= right.d;
+                    mpz_class carried = left.c * right.t;
+                    carried *= right.d;
+                    right.v *= left.d;
+                    carried += right.v;
+                    carried *= left.p;
+                    left.v += carried;
+                    //t = t_l q_r + p_l t_r
+                    left.t *= right.q;
+                    right.t *= left.p;
+                    left.t += right.t;
+                    //c / d = c_l / d_l + c_r / d_r
+                    left.c *= right.d;
+                    right.c *= left.d;
+                    left.c += right.c;
+                    left.d *= right.d;
+                    left.p *= right.p;
+                    left.q *= right.q;
+                }
+
+            private:
+                std::uint64_t n;
+            };
+        };
+    }
+}
+
+#endif
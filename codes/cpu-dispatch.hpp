@@ -0,0 +1,41 @@
+#ifndef UMJCUTIL_CPU_DISPATCH_HPP
+#define UMJCUTIL_CPU_DISPATCH_HPP
+
+#include <atomic>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+//the vector kernels are compiled with target attributes, so they exist whatever -march is; which one runs is decided here at runtime
+#define UMJCUTIL_CPU_DISPATCH_X86 1
+#endif
+
+namespace UMJCUtil {
+    /**
+     * @brief the one runtime choice of vector kernel, shared by every header that has several (SmallFactorFilter, LookupTable)
+     * the best kernel the CPU supports is picked on first use; set_kernel() overrides it for all of them at once.
+    */
+    namespace CpuDispatch {
+        enum class Kernel { scalar, avx2, avx512 };
+
+        inline Kernel supported_kernel() {
+#ifdef UMJCUTIL_CPU_DISPATCH_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) return Kernel::avx512;
+            if (__builtin_cpu_supports("avx2")) return Kernel::avx2;
+#endif
+            return Kernel::scalar;
+        }
+        inline std::atomic<Kernel>& selected_kernel() {
+            static std::atomic<Kernel> rtrn(supported_kernel());
+            return rtrn;
+        }
+        inline Kernel kernel() {
+            return selected_kernel().load(std::memory_order_relaxed);
+        }
+        //forces a slower kernel, for benchmarks; a kernel the CPU lacks falls back to the best one it has.
+        inline void set_kernel(Kernel requested) {
+            selected_kernel().store(requested <= supported_kernel() ? requested : supported_kernel());
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef UMJCUTIL_MATH_DIVISIBILITY_HPP
+#define UMJCUTIL_MATH_DIVISIBILITY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "cpu-dispatch.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief divisibility by a fixed odd d without dividing (Granlund-Montgomery)
+         * multiplying by d^-1 mod 2^w maps the multiples of d onto [0, (2^w - 1) / d] and every other n above it,
+         * so d | n costs one multiply and one compare, which also vectorizes.
+        */
+        template <typename U>
+        class DivisibilityTest {
+            static_assert(std::is_unsigned<U>::value, "the test works modulo 2^w on unsigned words");
+        public:
+            constexpr DivisibilityTest() = default;
+            constexpr explicit DivisibilityTest(U divisor) : inverse_(divisor), limit_(std::numeric_limits<U>::max() / divisor) {
+                //Newton iteration for d^-1 mod 2^w; d * d == 1 (mod 8) gives 3 correct bits and every step doubles them
+                for (int bits = 3; bits < std::numeric_limits<U>::digits; bits *= 2) inverse_ *= U(2) - divisor * inverse_;
+            }
+            constexpr bool divides(U n) const {
+                return U(n * inverse_) <= limit_;
+            }
+            constexpr U inverse() const { return inverse_; }
+            constexpr U limit() const { return limit_; }
+
+        private:
+            U inverse_ = 1;
+            U limit_ = std::numeric_limits<U>::max();
+        };
+
+        /**
+         * @brief flags the integers that have a prime factor among 2 and PRIMES, many lanes at a time
+         * the kernel (AVX-512, AVX2 or plain C++) is picked at runtime from what the CPU supports.
+         * a flagged n may still be one of those primes itself; the caller sorts that out.
+        */
+        namespace SmallFactorFilter {
+            //every odd prime below 2^9: past that each further prime rejects too few candidates to pay for its multiply
+            inline constexpr std::size_t PRIME_COUNT = 96;
+            inline constexpr std::array<std::uint32_t, PRIME_COUNT> PRIMES = [] {
+                std::array<std::uint32_t, PRIME_COUNT> rtrn = {};
+                std::size_t found = 0;
+                for (std::uint32_t n = 3; found < PRIME_COUNT; n += 2) {
+                    bool prime = true;
+                    for (std::size_t i = 0; i < found && rtrn[i] * rtrn[i] <= n; i++) {
+                        if (n % rtrn[i] == 0) prime = false;
+                    }
+                    if (prime) rtrn[found++] = n;
+                }
+                return rtrn;
+            }();
+            template <typename U>
+            inline constexpr std::array<DivisibilityTest<U>, PRIME_COUNT> TESTS = [] {
+                std::array<DivisibilityTest<U>, PRIME_COUNT> rtrn = {};
+                for (std::size_t i = 0; i < PRIME_COUNT; i++) rtrn[i] = DivisibilityTest<U>(PRIMES[i]);
+                return rtrn;
+            }();
+            //an unflagged n below this square is prime
+            inline constexpr std::uint64_t PRIME_BELOW = std::uint64_t(PRIMES.back()) * PRIMES.back();
+
+            //has_factor[i] = (n[i] has a factor among PRIMES[first, last), or among 2 too when first == 0)
+            template <typename U>
+            void mark_scalar(const U* n, std::size_t count, bool* has_factor, std::size_t first, std::size_t last) {
+                for (std::size_t i = 0; i < count; i++) {
+                    bool flagged = first == 0 && n[i] % 2 == 0;
+                    for (std::size_t k = first; k < last && !flagged; k++) flagged = TESTS<U>[k].divides(n[i]);
+                    has_factor[i] = flagged;
+                }
+            }
+
+#ifdef UMJCUTIL_CPU_DISPATCH_X86
+            //lanes hold candidates; every prime is broadcast and tested against all of them, so there is no branch per candidate.
+            __attribute__((target("avx2")))
+            inline void mark_avx2(const std::uint32_t* n, std::size_t count, bool* has_factor, std::size_t first, std::size_t last) {
+                std::size_t i = 0;
+                for (; i + 8 <= count; i += 8) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(n + i));
+                    __m256i flagged = first == 0 ? _mm256_cmpeq_epi32(_mm256_and_si256(v, _mm256_set1_epi32(1)), _mm256_setzero_si256()) : _mm256_setzero_si256();
+                    for (std::size_t k = first; k < last; k++) {
+                        const auto& test = TESTS<std::uint32_t>[k];
+                        __m256i product = _mm256_mullo_epi32(v, _mm256_set1_epi32(static_cast<int>(test.inverse())));
+                        //unsigned product <= limit exactly when min(product, limit) == product
+                        flagged = _mm256_or_si256(flagged, _mm256_cmpeq_epi32(_mm256_min_epu32(product, _mm256_set1_epi32(static_cast<int>(test.limit()))), product));
+                    }
+                    unsigned bits = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(flagged)));
+                    for (int lane = 0; lane < 8; lane++) has_factor[i + lane] = (bits >> lane) & 1;
+                }
+                mark_scalar(n + i, count - i, has_factor + i, first, last);
+            }
+            __attribute__((target("avx2")))
+            inline void mark_avx2(const std::uint64_t* n, std::size_t count, bool* has_factor, std::size_t first, std::size_t last) {
+                //AVX2 has neither a 64-bit low multiply nor an unsigned compare: build the first from three 32x32->64 ones,
+                //and compare signed after flipping the sign bits.
+                const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+                std::size_t i = 0;
+                for (; i + 4 <= count; i += 4) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(n + i));
+                    __m256i v_high = _mm256_srli_epi64(v, 32);
+                    __m256i flagged = first == 0 ? _mm256_cmpeq_epi64(_mm256_and_si256(v, _mm256_set1_epi64x(1)), _mm256_setzero_si256()) : _mm256_setzero_si256();
+                    for (std::size_t k = first; k < last; k++) {
+                        const auto& test = TESTS<std::uint64_t>[k];
+                        __m256i inverse = _mm256_set1_epi64x(static_cast<long long>(test.inverse()));
+                        __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(v_high, inverse), _mm256_mul_epu32(v, _mm256_srli_epi64(inverse, 32)));
+                        __m256i product = _mm256_add_epi64(_mm256_mul_epu32(v, inverse), _mm256_slli_epi64(cross, 32));
+                        __m256i above = _mm256_cmpgt_epi64(_mm256_xor_si256(product, sign), _mm256_set1_epi64x(static_cast<long long>(test.limit() ^ (std::uint64_t(1) << 63))));
+                        flagged = _mm256_or_si256(flagged, _mm256_xor_si256(above, _mm256_set1_epi64x(-1)));
+                    }
+                    unsigned bits = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(flagged)));
+                    for (int lane = 0; lane < 4; lane++) has_factor[i + lane] = (bits >> lane) & 1;
+                }
+                mark_scalar(n + i, count - i, has_factor + i, first, last);
+            }
+            __attribute__((target("avx512f,avx512dq")))
+            inline void mark_avx512(const std::uint32_t* n, std::size_t count, bool* has_factor, std::size_t first, std::size_t last) {
+                std::size_t i = 0;
+                for (; i + 16 <= count; i += 16) {
+                    __m512i v = _mm512_loadu_si512(n + i);
+                    __mmask16 flagged = first == 0 ? _mm512_testn_epi32_mask(v, _mm512_set1_epi32(1)) : 0;
+                    for (std::size_t k = first; k < last; k++) {
+                        const auto& test = TESTS<std::uint32_t>[k];
+                        __m512i product = _mm512_mullo_epi32(v, _mm512_set1_epi32(static_cast<int>(test.inverse())));
+                        flagged |= _mm512_cmple_epu32_mask(product, _mm512_set1_epi32(static_cast<int>(test.limit())));
+                    }
+                    for (int lane = 0; lane < 16; lane++) has_factor[i + lane] = (flagged >> lane) & 1;
+                }
+                mark_scalar(n + i, count - i, has_factor + i, first, last);
+            }
+            __attribute__((target("avx512f,avx512dq")))
+            inline void mark_avx512(const std::uint64_t* n, std::size_t count, bool* has_factor, std::size_t first, std::size_t last) {
+                std::size_t i = 0;
+                for (; i + 8 <= count; i += 8) {
+                    __m512i v = _mm512_loadu_si512(n + i);
+                    __mmask8 flagged = first == 0 ? _mm512_testn_epi64_mask(v, _mm512_set1_epi64(1)) : 0;
+                    for (std::size_t k = first; k < last; k++) {
+                        const auto& test = TESTS<std::uint64_t>[k];
+                        __m512i product = _mm512_mullo_epi64(v, _mm512_set1_epi64(static_cast<long long>(test.inverse())));
+                        flagged |= _mm512_cmple_epu64_mask(product, _mm512_set1_epi64(static_cast<long long>(test.limit())));
+                    }
+                    for (int lane = 0; lane < 8; lane++) has_factor[i + lane] = (flagged >> lane) & 1;
+                }
+                mark_scalar(n + i, count - i, has_factor + i, first, last);
+            }
+#endif
+
+            template <typename U>
+            void mark_range(const U* n, std::size_t count, bool* has_factor, std::size_t first, std::size_t last) {
+#ifdef UMJCUTIL_CPU_DISPATCH_X86
+                switch (CpuDispatch::kernel()) {
+                case CpuDispatch::Kernel::avx512:
+                    mark_avx512(n, count, has_factor, first, last);
+                    return;
+                case CpuDispatch::Kernel::avx2:
+                    mark_avx2(n, count, has_factor, first, last);
+                    return;
+                default:
+                    break;
+                }
+#endif
+                mark_scalar(n, count, has_factor, first, last);
+            }
+
+            //the vector kernels cannot stop early for a lane that is already flagged, so the primes are tried in stages
+            //and only the candidates that survived a stage are packed together for the next one.
+            //the primes up to 23 alone flag about two thirds of the odd candidates.
+            inline constexpr std::array<std::size_t, 3> STAGE_ENDS = { 8, 32, PRIME_COUNT };
+            inline constexpr std::size_t STAGE_BLOCK = 1024;
+
+            //has_factor[i] = (n[i] is even or divisible by one of PRIMES), with U = uint32_t or uint64_t
+            template <typename U>
+            void mark(const U* n, std::size_t count, bool* has_factor) {
+                static_assert(std::is_same<U, std::uint32_t>::value || std::is_same<U, std::uint64_t>::value, "the kernels exist for 32- and 64-bit lanes");
+                if (CpuDispatch::kernel() == CpuDispatch::Kernel::scalar) {
+                    mark_scalar(n, count, has_factor, 0, PRIME_COUNT);
+                    return;
+                }
+                std::array<U, STAGE_BLOCK> survivors;
+                std::array<std::uint32_t, STAGE_BLOCK> positions;
+                std::array<bool, STAGE_BLOCK> flagged;
+                for (std::size_t begin = 0; begin < count; begin += STAGE_BLOCK) {
+                    std::size_t size = std::min(STAGE_BLOCK, count - begin);
+                    mark_range(n + begin, size, has_factor + begin, 0, STAGE_ENDS[0]);
+                    std::size_t left = 0;
+                    for (std::size_t i = 0; i < size; i++) {
+                        survivors[left] = n[begin + i];
+                        positions[left] = static_cast<std::uint32_t>(begin + i);
+                        left += !has_factor[begin + i];
+                    }
+                    for (std::size_t stage = 1; stage < STAGE_ENDS.size() && left != 0; stage++) {
+                        mark_range(survivors.data(), left, flagged.data(), STAGE_ENDS[stage - 1], STAGE_ENDS[stage]);
+                        std::size_t kept = 0;
+                        for (std::size_t i = 0; i < left; i++) {
+                            has_factor[positions[i]] = flagged[i];
+                            survivors[kept] = survivors[i];
+                            positions[kept] = positions[i];
+                            kept += !flagged[i];
+                        }
+                        left = kept;
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef UMJCUTIL_TABLES_FACTORIAL_TABLE_HPP
+#define UMJCUTIL_TABLES_FACTORIAL_TABLE_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gmpxx.h>
+#include "thread-pool.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief n!, (n + 1)!, ... one multiplication each
+         * starting at n > 0 costs one mpz_fac_ui, GMP's prime-swing factorial with its own product trees,
+         * which is also the fastest way to an isolated large n!.
+        */
+        class FactorialSequence {
+        public:
+            explicit FactorialSequence(unsigned long n = 0) : n(n) {
+                mpz_fac_ui(value.get_mpz_t(), n);
+            }
+            unsigned long index() const { return n; }
+            const mpz_class& factorial() const { return value; }
+            //n <- n + 1
+            FactorialSequence& advance() {
+                mpz_mul_ui(value.get_mpz_t(), value.get_mpz_t(), ++n);
+                return *this;
+            }
+
+        private:
+            unsigned long n;
+            mpz_class value;
+        };
+    }
+
+    namespace Tables {
+        /**
+         * @brief copies the decimal digits [digits, digits + length) to out with a space after every `group` of them counted from the right,
+         * the last digit included, as lookup-table.tex sets long integers; returns the end of what was written.
+         * out needs room for length + length / group + 1 characters.
+        */
+        inline char* group_digits(const char* digits, std::size_t length, char* out, std::size_t group = 5) {
+            std::size_t head = length % group == 0 ? group : length % group;
+            for (std::size_t at = 0; at < length; at += head, head = group) {
+                out = std::copy(digits + at, digits + at + head, out);
+                *out++ = ' ';
+            }
+            return out;
+        }
+
+        /**
+         * @brief writes the longtable rows "    n & n!\\" for n = first, ..., last, with \hline after every n divisible by rule_every
+         * the factorials are made one multiplication apart, a block at a time, and the block's decimal conversions,
+         * which cost far more than the multiplications for large n, run in parallel on the shared ThreadPool.
+         * each block is written as soon as it is converted, so memory stays at about BLOCK_DIGITS characters whatever last is,
+         * and every block slot keeps its buffers, so converting allocates nothing once the digits stop growing.
+         * @param concurrency: at most this many threads convert, 0 for the pool's setting
+        */
+        class FactorialRows {
+        public:
+            //a block ends once it holds this many digits, or MAX_BLOCK_ROWS rows
+            static constexpr std::size_t BLOCK_DIGITS = std::size_t(1) << 22;
+            static constexpr std::size_t MAX_BLOCK_ROWS = 1024;
+
+            void write(std::ostream& out, unsigned long first, unsigned long last, unsigned long rule_every = 5, std::size_t concurrency = 0) {
+                if (first > last) return;
+                Math::FactorialSequence sequence(first);
+                for (unsigned long n = first;;) {
+                    //fill a block with copies of n!, (n + 1)!, ...
+                    std::size_t rows = 0, digits = 0;
+                    while (rows < MAX_BLOCK_ROWS && digits < BLOCK_DIGITS) {
+                        if (rows == slots.size()) slots.emplace_back();
+                        slots[rows].n = n;
+                        slots[rows].value = sequence.factorial();
+                        digits += mpz_sizeinbase(sequence.factorial().get_mpz_t(), 10);
+                        rows++;
+                        if (n == last) break;
+                        n++;
+                        sequence.advance();
+                    }
+                    ThreadPool::shared().parallel_for(rows, [&](std::size_t i) { format(slots[i], rule_every); }, concurrency);
+                    for (std::size_t i = 0; i < rows; i++) out.write(slots[i].row.data(), static_cast<std::streamsize>(slots[i].used));
+                    if (slots[rows - 1].n == last) return;
+                }
+            }
+
+        private:
+            struct Slot {
+                unsigned long n = 0;
+                mpz_class value;
+                std::vector<char> digits;
+                std::vector<char> row;
+                std::size_t used = 0;
+            };
+
+            static void format(Slot& slot, unsigned long rule_every) {
+                //mpz_sizeinbase may be one too large; mpz_get_str writes the exact digits and a terminating 0
+                std::size_t bound = mpz_sizeinbase(slot.value.get_mpz_t(), 10) + 2;
+                if (slot.digits.size() < bound) slot.digits.resize(bound);
+                mpz_get_str(slot.digits.data(), 10, slot.value.get_mpz_t());
+                std::size_t length = std::char_traits<char>::length(slot.digits.data());
+                //"    " n " & " grouped "\\\n" and maybe "    \hline\n"
+                std::size_t needed = 4 + 20 + 3 + length + length / 5 + 1 + 3 + 11;
+                if (slot.row.size() < needed) slot.row.resize(needed);
+                char* at = slot.row.data();
+                at = std::copy_n("    ", 4, at);
+                at = std::to_chars(at, at + 20, slot.n).ptr;
+                at = std::copy_n(" & ", 3, at);
+                at = group_digits(slot.digits.data(), length, at);
+                at = std::copy_n("\\\\\n", 3, at);
+                if (rule_every != 0 && slot.n % rule_every == 0) at = std::copy_n("    \\hline\n", 11, at);
+                slot.used = static_cast<std::size_t>(at - slot.row.data());
+            }
+
+            std::vector<Slot> slots;
+        };
+    }
+}
+
+#endif
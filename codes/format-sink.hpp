@@ -0,0 +1,161 @@
+#ifndef UMJCUTIL_TABLES_FORMAT_SINK_HPP
+#define UMJCUTIL_TABLES_FORMAT_SINK_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace UMJCUtil {
+    namespace Tables {
+        namespace FormatDetail {
+            //10^0, ..., 10^22 are exact in double
+            inline constexpr double EXACT_POWERS_OF_10[23] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            //exactly rounded by std::to_chars, which works on the exact binary value of x: about 70 ns
+            inline std::pair<int, int> sci_notation_exact(double x, int digits) {
+                //[-]d.ddddde[+-]xxx
+                char text[32];
+                char* end = std::to_chars(text, text + sizeof(text), x, std::chars_format::scientific, digits - 1).ptr;
+                const char* at = text;
+                bool negative = *at == '-';
+                if (negative) at++;
+                int significands = 0;
+                for (; *at != 'e'; at++) {
+                    if (*at != '.') significands = significands * 10 + (*at - '0');
+                }
+                at++;
+                if (*at == '+') at++;
+                int exp = 0;
+                std::from_chars(at, end, exp);
+                return std::make_pair(negative ? -significands : significands, exp);
+            }
+        }
+
+        /**
+         * @brief x rounded to `digits` significant digits, as (significand, decimal exponent)
+         * the rounding is exact: the result is what rounding the exact binary value of x in decimal gives, with no log10/pow round-off,
+         * and a significand that rounds up to 10^digits is carried into the exponent, so 9.99996 gives (10000, 1).
+         * digits must be between 1 and 9 for the significand to fit in an int.
+        */
+        inline std::pair<int, int> get_sci_notation(double x, int digits = 5) {
+            if (x == 0.0) return std::make_pair<int, int>(0, 0);
+            if (x < 0.0) {
+                std::pair<int, int> rtrn = get_sci_notation(-x, digits);
+                return std::make_pair(-rtrn.first, rtrn.second);
+            }
+            if (!std::isfinite(x) || digits < 1 || digits > 9) return FormatDetail::sci_notation_exact(x, digits);
+            //x = q * 10^(exp - digits + 1) with q in [10^(digits - 1), 10^digits), found with one exact power of 10 and one rounding:
+            //q is then within 10^9 * 2^-53 of its exact value, so unless it is that close to a half the rounding below is the exact one.
+            const double q_max = FormatDetail::EXACT_POWERS_OF_10[digits];
+            //floor(e2 log10 2) <= floor(log10 x) for x in [2^e2, 2^(e2 + 1)), and it is off by at most one
+            int exp = static_cast<int>(std::floor(std::ilogb(x) * 0.30102999566398120));
+            while (true) {
+                int shift = digits - 1 - exp;
+                if (shift > 22 || shift < -22) return FormatDetail::sci_notation_exact(x, digits);
+                double q = shift >= 0 ? x * FormatDetail::EXACT_POWERS_OF_10[shift] : x / FormatDetail::EXACT_POWERS_OF_10[-shift];
+                if (q >= q_max) {
+                    exp++;
+                    continue;
+                }
+                double whole = std::floor(q);
+                double fraction = q - whole;
+                if (std::fabs(fraction - 0.5) < 1e-6) return FormatDetail::sci_notation_exact(x, digits);
+                int significands = static_cast<int>(whole) + (fraction > 0.5 ? 1 : 0);
+                if (significands == static_cast<int>(q_max)) return std::make_pair(significands / 10, exp + 1);
+                return std::make_pair(significands, exp);
+            }
+        }
+
+        //how a cell value is written: \({significand}_{exponent}\)
+        struct SciFormat {
+            int digits = 5;
+            //print the exponent's sign even when it is positive, as std::showpos would
+            bool signed_exponent = true;
+        };
+
+        /**
+         * @brief text buffer that formats numbers with std::to_chars and goes to the stream in one write
+         * the buffer keeps its capacity across flush(), so once it has grown to a table's size formatting allocates nothing.
+        */
+        class FormatSink {
+        public:
+            explicit FormatSink(std::ostream& out, std::size_t initial_capacity = std::size_t(1) << 16) : out(out) {
+                reserve(initial_capacity);
+            }
+            FormatSink(const FormatSink&) = delete;
+            FormatSink& operator=(const FormatSink&) = delete;
+            ~FormatSink() {
+                flush();
+            }
+
+            FormatSink& text(std::string_view value) {
+                std::memcpy(extend(value.size()), value.data(), value.size());
+                return *this;
+            }
+            template <typename Integer>
+            FormatSink& integer(Integer value, bool show_plus = false) {
+                constexpr std::size_t MAX_CHARS = std::numeric_limits<Integer>::digits10 + 3;
+                char* at = reserve(MAX_CHARS + 1);
+                if (show_plus && value >= Integer(0)) *at++ = '+';
+                used = static_cast<std::size_t>(std::to_chars(at, at + MAX_CHARS, value).ptr - buffer.get());
+                return *this;
+            }
+            //\({significand}_{exponent}\)
+            FormatSink& sci(double value, const SciFormat& format = {}) {
+                std::pair<int, int> sci = get_sci_notation(value, format.digits);
+                text("\\({");
+                integer(sci.first);
+                text("}_{");
+                integer(sci.second, format.signed_exponent);
+                return text("}\\)");
+            }
+
+            std::string_view view() const {
+                return std::string_view(buffer.get(), used);
+            }
+            //one write of everything formatted since the last flush
+            void flush() {
+                if (used == 0) return;
+                out.write(buffer.get(), static_cast<std::streamsize>(used));
+                used = 0;
+            }
+
+        private:
+            //room for at least n more characters past the end, which stays where it is
+            char* reserve(std::size_t n) {
+                if (used + n > capacity) {
+                    std::size_t grown = std::max(capacity * 2, used + n);
+                    std::unique_ptr<char[]> larger(new char[grown]);
+                    if (used != 0) std::memcpy(larger.get(), buffer.get(), used);
+                    buffer = std::move(larger);
+                    capacity = grown;
+                }
+                return buffer.get() + used;
+            }
+            //the next n characters, to be filled in by the caller
+            char* extend(std::size_t n) {
+                char* rtrn = reserve(n);
+                used += n;
+                return rtrn;
+            }
+
+            std::ostream& out;
+            std::unique_ptr<char[]> buffer;
+            std::size_t used = 0;
+            std::size_t capacity = 0;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include <iostream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "constants.hpp"
+
+using UMJCUtil::Math::Constants;
+
+namespace {
+    struct Entry {
+        const char* symbol;
+        const char* detail;
+        //floor(value * 10^digits)
+        std::function<mpz_class(std::size_t digits)> scaled;
+        bool rule_after = false;
+        //the most digits scaled() knows
+        std::size_t precision = static_cast<std::size_t>(-1);
+    };
+
+    //the constants no series or iteration here converges to are kept as lookup-table.tex has them, to TABULATED_DIGITS
+    constexpr std::size_t TABULATED_DIGITS = 20;
+    std::function<mpz_class(std::size_t)> tabulated(const char* value) {
+        return [value](std::size_t digits) {
+            mpz_class rtrn(value), power;
+            mpz_ui_pow_ui(power.get_mpz_t(), 10, TABULATED_DIGITS - digits);
+            mpz_fdiv_q(rtrn.get_mpz_t(), rtrn.get_mpz_t(), power.get_mpz_t());
+            return rtrn;
+        };
+    }
+
+    //the width of s in a monospaced editor, Hangul taking two columns, as lookup-table.tex aligns its columns
+    std::size_t display_width(const std::string& s) {
+        std::size_t rtrn = 0;
+        for (std::size_t i = 0; i < s.size();) {
+            unsigned char lead = static_cast<unsigned char>(s[i]);
+            std::size_t length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+            rtrn += length == 3 ? 2 : 1;
+            i += length;
+        }
+        return rtrn;
+    }
+    std::string pad(const std::string& s, std::size_t width) {
+        std::size_t used = display_width(s);
+        return s + std::string(used < width ? width - used : 1, ' ');
+    }
+
+    //"3.14159 26535 ..." with GROUPS_PER_LINE groups of 5 decimals a row, the rows after the first continuing the value column
+    constexpr std::size_t GROUPS_PER_LINE = 10;
+    //scaled = floor(value * 10^digits)
+    void write_value(std::ostream& out, const mpz_class& scaled, std::size_t digits) {
+        std::string text = scaled.get_str();
+        if (text.size() <= digits) text.insert(0, digits + 1 - text.size(), '0');
+        std::size_t point = text.size() - digits;
+        out << text.substr(0, point) << '.';
+        for (std::size_t at = 0; at < digits; at += 5) {
+            if (at != 0) out << (at % (5 * GROUPS_PER_LINE) == 0 ? "\\\\\n    & & " : " ");
+            out << text.substr(point + at, std::min<std::size_t>(5, digits - at));
+        }
+        out << "\\\\\n";
+    }
+}
+
+//usage: generate-constants [digits]
+//the table of constants at the top of lookup-table.tex to `digits` decimals (20 by default), truncated, in groups of 5.
+//the Feigenbaum and Bernstein constants stay at the 20 decimals the table gives.
+//build: g++ -std=gnu++20 -O2 generate-constants.cpp -lgmpxx -lgmp
+int main(int argc, char* argv[]) {
+    const std::size_t digits = argc > 1 ? std::stoul(argv[1]) : 20;
+    auto computed = [](mpz_class (*value)(std::size_t, std::size_t)) {
+        return [value](std::size_t digits) { return Constants::decimal(value, digits); };
+    };
+    auto root = [](unsigned long n, unsigned long k) {
+        return [n, k](std::size_t digits) { return Constants::root_decimal(n, k, digits); };
+    };
+    std::vector<Entry> entries = {
+        { "\\(\\pi\\)", "원주율", computed(Constants::pi) },
+        { "\\(\\tau\\)", "새원주율", computed([](std::size_t bits, std::size_t concurrency) { return Constants::pi(bits + 1, concurrency); }) },
+        { "\\(\\sqrt{2}\\)", "2의 제곱근", root(2, 2) },
+        { "\\(\\sqrt{3}\\)", "3의 제곱근", root(3, 2) },
+        { "\\(\\sqrt{5}\\)", "5의 제곱근", root(5, 2), true },
+        //(1 + sqrt(5)) / 2 truncates to (10^digits + floor(sqrt(5) 10^digits)) / 2
+        { "\\(\\phi\\)", "황금비", [](std::size_t digits) {
+            mpz_class power;
+            mpz_ui_pow_ui(power.get_mpz_t(), 10, digits);
+            return mpz_class((power + Constants::root_decimal(5, 2, digits)) >> 1);
+        } },
+        { "\\(\\sqrt[3]{2}\\)", "2의 세제곱근", root(2, 3) },
+        { "\\(\\sqrt[3]{3}\\)", "3의 세제곱근", root(3, 3) },
+        { "\\(\\sqrt[12]{2}\\)", "2의 12제곱근", root(2, 12) },
+        { "\\(e\\)", "자연로그의 밑", computed(Constants::e), true },
+        { "\\(\\ln{2}\\)", "2의 자연로그", computed(Constants::ln2) },
+        { "\\(\\gamma\\)", "Euler-Mascheroni 상수", computed(Constants::euler_gamma) },
+        { "\\(\\Omega\\)", "오메가 상수", computed(Constants::omega) },
+        { "\\(\\delta\\)", "제1 Feigenbaum 상수", tabulated("466920160910299067185"), false, TABULATED_DIGITS },
+        { "\\(\\alpha\\)", "제2 Feigenbaum 상수", tabulated("250290787509589282228"), true, TABULATED_DIGITS },
+        { "\\(\\beta\\)", "Bernstein 상수", tabulated("28016949902386913303"), false, TABULATED_DIGITS },
+        { "\\(\\zeta\\left(3\\right)\\)", "Ap\\'ery 상수", computed(Constants::zeta3) },
+        { "\\(\\rho\\)", "소수 상수", computed(Constants::prime_constant) },
+    };
+
+    std::ios_base::sync_with_stdio(false);
+    std::cout <<
+        "\\begin{longtable}{l | l l}\n"
+        "    기호 & 상세 & 값(소수점 아래 " << digits << "자리까지)\\\\\n"
+        "    \\hline\\hline\n";
+    for (const auto& entry : entries) {
+        std::size_t shown = std::min(digits, entry.precision);
+        std::cout << "    " << pad(entry.symbol, 32) << "& " << pad(entry.detail, 38) << "& ";
+        write_value(std::cout, entry.scaled(shown), shown);
+        if (entry.rule_after) std::cout << "    \\hline\n";
+    }
+    std::cout << "\\end{longtable}";
+    return 0;
+}
@@ -1,54 +1,52 @@
 #include <iostream>
-#include <iostream>
-#include <cmath>
-#include <boost/math/distributions.hpp>
+#include <sstream>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "quantile-solver.hpp"
+#include "table-engine.hpp"
 
-constexpr std::pair<int, int> get_sci_notation(double x, int digits = 5) {
-    if (x == 0.0) return std::make_pair<int, int>(0, 0);
-    else {
-        int significands = static_cast<int>(std::round(x * std::pow(10.0, -std::floor(std::log10(x)) + static_cast<double>(digits) - 1.0)));
-        int exp = static_cast<int>(std::floor(std::log10(x)));
-        int significands_max = 1;
-        for (int i = 0; i < digits; i++) significands_max *= 10;
-        if (significands == significands_max) {
-            significands /= 10;
-            ++exp;
-        }
-        return std::make_pair(significands, exp);
-    }
-}
-
-int main() {
+//usage: generate-f [r1_max] [r2_max]
+//one page per significance level and 10 columns of r1, r2 = 1, ..., r2_max down the rows; 30 and 30 by default.
+int main(int argc, char* argv[]) {
     constexpr double SIGNIFICANCE_LEVEL[] = {0.001, 0.005, 0.010, 0.025, 0.05};
-    std::ios_base::fmtflags old_flags;
-    for (int k = 0; k < 5; k++) {
-        std::cout << 
-            "\\(\\alpha\\)=" << SIGNIFICANCE_LEVEL[k] << "\n\n";
-        for (int p = 0; p < 3; p++) {
-            std::cout << 
+    const int r1_max = argc > 1 ? std::stoi(argv[1]) : 30;
+    const int r2_max = argc > 2 ? std::stoi(argv[2]) : 30;
+    //UMJCUTIL_QUANTILE_CACHE names a file that keeps the quantiles between runs
+    const char* cache_path = std::getenv("UMJCUTIL_QUANTILE_CACHE");
+    UMJCUtil::Math::QuantileSolver solver(cache_path != nullptr ? cache_path : "");
+    std::vector<UMJCUtil::Tables::Table> tables;
+    for (double alpha : SIGNIFICANCE_LEVEL) {
+        for (int p = 0; p * 10 < r1_max; p++) {
+            UMJCUtil::Tables::Table table;
+            std::ostringstream header;
+            if (p == 0) header << "\\(\\alpha\\)=" << alpha << "\n\n";
+            header <<
                 "\\begin{tabular}{c || c c c c c | c c c c c}\n"
                 "    \\multirow{2}{*}{\\(r_2\\)} & \\multicolumn{10}{c}{\\(r_1\\)} \\\\\n"
                 "    & ";
             for (int j = 0; j < 10; j++) {
-                std::cout << (j + 10 * p + 1) << (j + 1 < 10 ? " & " : "\\\\\n");
+                header << (j + 10 * p + 1) << (j + 1 < 10 ? " & " : "\\\\\n");
             }
-            std::cout << 
+            header <<
                 "    \\hline\\hline\n";
-            for (int i = 1; i <= 30; i++) {
-                std::cout << "    " << i << " & ";
-                for (int j = 1; j <= 10; j++) {
-                    double y = boost::math::quantile(boost::math::fisher_f(j + 10 * p, i), 1.0 - SIGNIFICANCE_LEVEL[k]);
-                    std::pair<int, int> sci = get_sci_notation(y, 5);
-                    old_flags = std::cout.flags();
-                    std::cout << "\\({" << sci.first << "}_{" << std::showpos << sci.second << std::noshowpos << "}\\)" << (j + 1 <= 10 ? " & " : "\\\\\n");
-                    std::cout.flags(old_flags);
-                }
-                if (i % 5 == 0) std::cout << "    \\hline\n";
-            }
-            std::cout << 
+            table.header = header.str();
+            table.rows = r2_max;
+            table.columns = 10;
+            table.row_label = [](std::size_t i) { return std::to_string(i + 1); };
+            table.chained_cell = [&solver, alpha, p](std::size_t i, std::size_t j, std::span<const double> above) {
+                return solver.fisher_f(static_cast<double>(j + 1 + 10 * p), static_cast<double>(i + 1), alpha, above);
+            };
+            table.rule_every = 5;
+            table.footer =
                 "\\end{tabular}\n"
                 "\\pagebreak\n";
+            tables.push_back(table);
         }
     }
+    UMJCUtil::Tables::render(std::cout, tables);
+    auto stats = solver.statistics();
+    std::cerr << stats.queries << " quantiles: " << stats.cache_hits << " cached, " << stats.solves << " solved in " << stats.iterations << " iterations, " << stats.fallbacks << " fallbacks\n";
     return 0;
-}
\ No newline at end of file
+}
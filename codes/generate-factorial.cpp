@@ -1,23 +1,18 @@
 #include <iostream>
-#include <iomanip>
-#include <gmpxx.h>
+#include <string>
+#include "factorial-table.hpp"
 
-int main(void) {
-    std::cout << 
+//usage: generate-factorial [n_max] [n_min]
+//n! for n = n_min, ..., n_max (1, ..., 49 by default)
+int main(int argc, char* argv[]) {
+    const unsigned long n_max = argc > 1 ? std::stoul(argv[1]) : 49;
+    const unsigned long n_min = argc > 2 ? std::stoul(argv[2]) : 1;
+    std::ios_base::sync_with_stdio(false);
+    std::cout <<
         "\\begin{longtable}{l | r}\n"
         "    \\(n\\) & \\(n!\\)\\\\\n"
         "    \\hline\\hline\n";
-    for (int i = 1; i < 50; i++) {
-        mpz_class fact = factorial(static_cast<mpz_class>(i));
-        std::string fact_str = fact.get_str();
-        std::cout << "    " << i << " & ";
-        for (std::size_t j = 0; j < fact_str.length(); j++) {
-            std::cout << fact_str[j];
-            if ((fact_str.length() - j) % 5 == 1) std::cout << " ";
-        }
-        std::cout << "\\\\\n";
-        if (i % 5 == 0) std::cout << "    \\hline\n";
-    }
+    UMJCUtil::Tables::FactorialRows().write(std::cout, n_min, n_max);
     std::cout << "\\end{longtable}";
     return 0;
-}
\ No newline at end of file
+}
@@ -1,31 +1,24 @@
 #include <iostream>
-#include <iomanip>
-#include <cmath>
-#include <cfloat>
-
-constexpr std::pair<int, int> get_sci_notation(double x, int digits = 5) {
-    if (x == 0.0) return std::make_pair<int, int>(0, 0);
-    else return std::make_pair<int, int>(
-        std::round(x * std::pow(10.0, -std::floor(std::log10(x)) + static_cast<double>(digits) - 1.0)), 
-        std::floor(std::log10(x))
-    );
-}
+#include <string>
+#include "table-engine.hpp"
+#include "table-functions.hpp"
 
 int main(int argc, char** argv) {
-    std::cout   << "\\begin{longtable}{c || c c c c c | c c c c c}\n"
-                << "    \\(x\\) & 0 & 1 & 2 & 3 & 4 & 5 & 6 & 7 & 8 & 9\\\\\n"
-                << "    \\hline\\hline\n";
-    for (int i = 10; i < 100; i++) {
-        std::cout << "    " << (i / 10) << "." << (i % 10) << " & ";
-        for (int j = 0; j < 10; j++) {
-            double x = static_cast<double>(i * 10 + j);
-            x /= 100.0;
-            double y = std::log10(x);
-            std::pair<int, int> sci = get_sci_notation(y, 5);
-            std::cout << "\\({" << sci.first << "}_{" << sci.second << "}\\)" << (j + 1 < 10 ? " & " : "\\\\\n");
-        }
-        if (i % 10 == 9) std::cout << "    \\hline\n";
-    }
-    std::cout   << "\\end{longtable}\n";
+    UMJCUtil::Tables::Table table;
+    table.header =
+        "\\begin{longtable}{c || c c c c c | c c c c c}\n"
+        "    \\(x\\) & 0 & 1 & 2 & 3 & 4 & 5 & 6 & 7 & 8 & 9\\\\\n"
+        "    \\hline\\hline\n";
+    //x = 1.00, ..., 9.99
+    table.rows = 90;
+    table.columns = 10;
+    table.row_label = [](std::size_t i) { return std::to_string((i + 10) / 10) + "." + std::to_string((i + 10) % 10); };
+    using Func = UMJCUtil::Math::CommonLogarithm;
+    table.cell = [](std::size_t i, std::size_t j) { return Func::value(Func::argument(static_cast<int>(i * 10 + j) + Func::FIRST)); };
+    table.format.signed_exponent = false;
+    table.rule_every = 10;
+    table.footer =
+        "\\end{longtable}\n";
+    UMJCUtil::Tables::render(std::cout, table);
     return 0;
-}
\ No newline at end of file
+}
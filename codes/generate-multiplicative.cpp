@@ -0,0 +1,34 @@
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include "linear-sieve.hpp"
+
+//usage: generate-multiplicative [n_max]
+//n, its prime factorization, phi(n), mu(n) and d(n) for n = 1, ..., n_max (100 by default)
+int main(int argc, char* argv[]) {
+    const std::uint32_t n_max = argc > 1 ? static_cast<std::uint32_t>(std::stoul(argv[1])) : 100;
+    UMJCUtil::Math::LinearSieve sieve(n_max);
+    auto functions = sieve.arithmetic_functions(1, n_max);
+    std::ios_base::sync_with_stdio(false);
+    std::cout <<
+        "\\begin{longtable}{r | l | r r r}\n"
+        "    \\(n\\) & 소인수분해 & \\(\\varphi\\left(n\\right)\\) & \\(\\mu\\left(n\\right)\\) & \\(d\\left(n\\right)\\)\\\\\n"
+        "    \\hline\\hline\n";
+    //a 32-bit n would wrap past n_max = 2^32 - 1 and never stop
+    for (std::uint64_t n = 1; n <= n_max; n++) {
+        std::size_t i = static_cast<std::size_t>(n - 1);
+        std::cout << "    " << n << " & \\(";
+        if (n == 1) std::cout << "1";
+        bool first = true;
+        for (auto [p, e] : sieve.factor_small(static_cast<std::uint32_t>(n))) {
+            if (!first) std::cout << " \\cdot ";
+            std::cout << p;
+            if (e > 1) std::cout << "^{" << e << "}";
+            first = false;
+        }
+        std::cout << "\\) & " << functions.totient[i] << " & " << int(functions.mobius[i]) << " & " << functions.divisor_count[i] << "\\\\\n";
+        if (n % 10 == 0) std::cout << "    \\hline\n";
+    }
+    std::cout << "\\end{longtable}";
+    return 0;
+}
@@ -0,0 +1,18 @@
+#include <iostream>
+#include <string>
+#include "prime-table-file.hpp"
+
+//usage: generate-prime-table-file <path> <limit> [stride]
+//writes the mod-30 wheel bitmap of every prime up to limit, with a pi checkpoint every stride bytes, for Primes<T>::attach_table_file().
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <path> <limit> [stride]\n";
+        return 1;
+    }
+    std::uint64_t limit = std::stoull(argv[2]);
+    std::uint64_t stride = argc > 3 ? std::stoull(argv[3]) : UMJCUtil::Math::PrimeTableFile::DEFAULT_STRIDE;
+    UMJCUtil::Math::PrimeTableFile::write(argv[1], limit, stride);
+    UMJCUtil::Math::PrimeTableFile table(argv[1]);
+    std::cout << "pi(" << table.limit() << ") = " << table.pi(table.limit()) << "\n";
+    return 0;
+}
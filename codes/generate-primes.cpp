@@ -2,23 +2,21 @@
 #include "primes.hpp"
 
 int main(int argc, char* argv[]) {
-    int x = 2;
+    using Primes = UMJCUtil::Math::Primes<int>;
     int primes = 0;
     std::cout << 
         "\\begin{longtable}{c c c c c c c c c c c c c c}\n"
         "    \\hline\n";
-    while (primes < 14 * 90) {
-        if (UMJCUtil::Math::Primes<int>::is_prime(x)) {
-            primes++;
-            if (primes % 14 == 1) std::cout << "    ";
-            std::cout << x << " ";
-            if (primes % 14 == 0) {
-                std::cout << "\\\\\n";
-                if (primes % 140 == 0) std::cout << "    \\hline\n";
-            }
-            else std::cout << "& ";
+    //the first 14 * 90 primes, sieved in one pass up to the last of them
+    for (int x : Primes::primes_between(2, Primes::nth_prime(14 * 90))) {
+        primes++;
+        if (primes % 14 == 1) std::cout << "    ";
+        std::cout << x << " ";
+        if (primes % 14 == 0) {
+            std::cout << "\\\\\n";
+            if (primes % 140 == 0) std::cout << "    \\hline\n";
         }
-        x++;
+        else std::cout << "& ";
     }
     std::cout << 
         "\\end{longtable}\n";
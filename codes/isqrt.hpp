@@ -1,12 +1,57 @@
 #ifndef UMJCUTIL_MATH_ISQRT_HPP
 #define UMJCUTIL_MATH_ISQRT_HPP
 
+#include <cmath>
 #include <type_traits>
 #include <stdexcept>
 #include <limits>
 
 namespace UMJCUtil {
     namespace Math {
+        namespace ISqrtDetail {
+            //floor(sqrt(x)) of an unsigned x by Newton's method from above; only integer operations, so it runs in constant evaluation.
+            template <typename U>
+            constexpr U newton(U x) {
+                if (x < U(2)) return x;
+                int bits = 0;
+                for (U rest = x; rest != U(0); rest >>= 1) bits++;
+                //2^ceil(bits / 2) >= sqrt(x), and from above the iterates fall monotonically to the floor
+                U rtrn = U(1) << ((bits + 1) / 2);
+                for (U next = (rtrn + x / rtrn) / 2; next < rtrn; next = (rtrn + x / rtrn) / 2) rtrn = next;
+                return rtrn;
+            }
+
+            //a floating-point estimate, then a correction made exact with squares that cannot overflow
+            template <typename U>
+            U hardware(U x) {
+                constexpr int DIGITS = std::numeric_limits<U>::digits;
+                //the largest root whose square still fits in U
+                constexpr U MAX_ROOT = (U(1) << (DIGITS / 2)) - U(1);
+                U rtrn;
+                if constexpr (DIGITS <= 64) {
+                    //double has 53 bits, so the estimate is off by at most one
+                    rtrn = static_cast<U>(std::sqrt(static_cast<double>(x)));
+                }
+                else if constexpr (std::numeric_limits<long double>::digits >= 64) {
+                    //x87 extended precision keeps a 64-bit estimate of a 128-bit x within one as well
+                    rtrn = static_cast<U>(std::sqrt(static_cast<long double>(x)));
+                }
+                else {
+                    //a 53-bit estimate is close to the root but not within one; a single Newton step squares the relative error
+                    rtrn = static_cast<U>(std::sqrt(static_cast<double>(x)));
+                    if (rtrn != U(0)) rtrn = (rtrn + x / rtrn) / 2;
+                }
+                if (rtrn > MAX_ROOT) rtrn = MAX_ROOT;
+                while (rtrn * rtrn > x) rtrn--;
+                while (rtrn < MAX_ROOT && (rtrn + U(1)) * (rtrn + U(1)) <= x) rtrn++;
+                return rtrn;
+            }
+        }
+
+        /**
+         * @brief floor(sqrt(x)) for every integral type, unsigned __int128 included
+         * at runtime the hardware square root gives an estimate that is corrected exactly; in constant evaluation Newton's method does the job.
+        */
         template <typename T>
         constexpr T isqrt(T x) {
             static_assert(std::is_fundamental<T>::value, "this template was targeted for the fundamental types");
@@ -14,21 +59,16 @@ namespace UMJCUtil {
             if (x < T(0)) {
                 throw std::domain_error("you cannot calculate square root of a negative number");
             }
-            std::size_t bit_size = std::numeric_limits<T>::digits;
-            if (bit_size % 2 != 0) bit_size++;
-            T rtrn(0);
-            T multiplier(T(1) << (bit_size - 2));
-            T subtracted(x);
-            for (T i = T(0); i < T(bit_size / 2); i++) {
-                T j = ((rtrn << 2) + T(1)) * multiplier > subtracted ? T(0) : T(1);
-                if (j) subtracted -= ((rtrn << 2) + T(1)) * multiplier;
-                rtrn <<= 1;
-                rtrn |= j;
-                multiplier >>= 2;
+            if constexpr (std::is_same<T, bool>::value) {
+                return x;
+            }
+            else {
+                using U = std::make_unsigned_t<T>;
+                if (std::is_constant_evaluated()) return static_cast<T>(ISqrtDetail::newton(static_cast<U>(x)));
+                return static_cast<T>(ISqrtDetail::hardware(static_cast<U>(x)));
             }
-            return rtrn;
         }
     }
 }
 
-#endif
\ No newline at end of file
+#endif
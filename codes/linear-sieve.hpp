@@ -0,0 +1,189 @@
+#ifndef UMJCUTIL_MATH_LINEAR_SIEVE_HPP
+#define UMJCUTIL_MATH_LINEAR_SIEVE_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "isqrt.hpp"
+#include "sieve.hpp"
+#include "thread-pool.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief the smallest prime factor of every n up to limit, by a linear sieve: each composite is written once, in O(limit)
+         * for bulk work over all of [1, limit]: factoring every n, or phi, mu and d of whole ranges. for scattered large n use Primes<T>::factor(),
+         * and for phi, mu and d of a window far from 0 segmented_arithmetic_functions(), which needs no table.
+         * the table keeps odd n only, and marks primes with 0, so that an entry, at most isqrt(limit) < 2^16, takes 2 bytes:
+         * one byte per integer covered, a quarter of a plain uint32 table.
+        */
+        class LinearSieve {
+        public:
+            //phi(n), mu(n) and d(n) (the number of divisors) for n = low, ..., high
+            struct ArithmeticFunctions {
+                std::uint32_t low = 1;
+                std::vector<std::uint32_t> totient;
+                std::vector<std::int8_t> mobius;
+                //d(n) <= 1344 below 2^32
+                std::vector<std::uint16_t> divisor_count;
+            };
+
+            explicit LinearSieve(std::uint32_t limit) : limit_(limit), table(limit / 2 + 1, 0) {
+                const std::uint32_t root = isqrt(limit);
+                //odd primes up to isqrt(limit): a prime above it times any odd i >= it is past limit
+                for (std::uint64_t i = 3; i * 3 <= limit; i += 2) {
+                    std::uint32_t smallest = table[i / 2];
+                    if (smallest == 0) {
+                        smallest = static_cast<std::uint32_t>(i);
+                        if (i <= root) odd_primes.push_back(static_cast<std::uint16_t>(i));
+                    }
+                    //i * p for every prime p up to the smallest factor of i: the one way to reach each odd composite
+                    for (std::uint16_t p : odd_primes) {
+                        if (p > smallest || i * p > limit) break;
+                        table[i * p / 2] = p;
+                    }
+                }
+            }
+
+            std::uint32_t limit() const { return limit_; }
+
+            //n in [2, limit]
+            std::uint32_t smallest_prime_factor(std::uint32_t n) const {
+                if (n < 2 || n > limit_) throw std::domain_error("the value is out of the range of the linear sieve");
+                if (n % 2 == 0) return 2;
+                return table[n / 2] == 0 ? n : table[n / 2];
+            }
+
+            /**
+             * @brief prime factorization of n in [1, limit] as (prime, exponent) pairs in ascending order of the primes, as Primes<T>::factor() gives it
+             * one table lookup and one division per prime factor, O(log n).
+            */
+            std::vector<std::pair<std::uint32_t, int>> factor_small(std::uint32_t n) const {
+                if (n == 0 || n > limit_) throw std::domain_error("the value is out of the range of the linear sieve");
+                std::vector<std::pair<std::uint32_t, int>> rtrn = {};
+                for_each_prime_power(n, [&rtrn](std::uint32_t p, int e, std::uint32_t) { rtrn.push_back({ p, e }); });
+                return rtrn;
+            }
+
+            /**
+             * @brief phi, mu and d of every n in [low, high], all three from one walk down each n's factor chain
+             * the range is cut into CHUNK-sized pieces handed to the shared ThreadPool; every n is independent of the others,
+             * so the pieces need no order among themselves.
+             * @param concurrency: at most this many threads work on the call, 0 for the pool's setting
+            */
+            ArithmeticFunctions arithmetic_functions(std::uint32_t low, std::uint32_t high, std::size_t concurrency = 0) const {
+                if (low == 0 || high > limit_) throw std::domain_error("the range is out of the range of the linear sieve");
+                ArithmeticFunctions rtrn;
+                rtrn.low = low;
+                if (low > high) return rtrn;
+                std::size_t count = static_cast<std::size_t>(high - low) + 1;
+                rtrn.totient.resize(count);
+                rtrn.mobius.resize(count);
+                rtrn.divisor_count.resize(count);
+                ThreadPool::shared().parallel_for((count + CHUNK - 1) / CHUNK, [&](std::size_t c) {
+                    std::size_t end = std::min(count, (c + 1) * CHUNK);
+                    for (std::size_t i = c * CHUNK; i < end; i++) {
+                        std::uint32_t totient = 1;
+                        std::int8_t mobius = 1;
+                        std::uint16_t divisor_count = 1;
+                        for_each_prime_power(static_cast<std::uint32_t>(low + i), [&](std::uint32_t p, int e, std::uint32_t power) {
+                            //phi(p^e) = p^e - p^(e - 1)
+                            totient *= power - power / p;
+                            mobius = e == 1 ? static_cast<std::int8_t>(-mobius) : std::int8_t(0);
+                            divisor_count *= static_cast<std::uint16_t>(e + 1);
+                        });
+                        rtrn.totient[i] = totient;
+                        rtrn.mobius[i] = mobius;
+                        rtrn.divisor_count[i] = divisor_count;
+                    }
+                }, concurrency);
+                return rtrn;
+            }
+
+            /**
+             * @brief phi, mu and d of every n in [low, high] without a table up to high, for windows far from 0
+             * each CHUNK-sized window keeps what is left of its n after dividing out the primes up to isqrt(high) found so far;
+             * whatever stays above 1 at the end is the one prime factor beyond isqrt(high). working memory is
+             * O(CHUNK) per thread plus the primes up to isqrt(high) (6542 of them at most), and the windows run on the shared ThreadPool.
+             * @param concurrency: at most this many threads work on the call, 0 for the pool's setting
+            */
+            static ArithmeticFunctions segmented_arithmetic_functions(std::uint32_t low, std::uint32_t high, std::size_t concurrency = 0) {
+                if (low == 0) throw std::domain_error("the range must start at 1 or above");
+                ArithmeticFunctions rtrn;
+                rtrn.low = low;
+                if (low > high) return rtrn;
+                std::size_t count = static_cast<std::size_t>(high - low) + 1;
+                rtrn.totient.assign(count, 1);
+                rtrn.mobius.assign(count, 1);
+                rtrn.divisor_count.assign(count, 1);
+                const std::vector<std::uint64_t> primes = SegmentedSieve::primes_up_to(isqrt(high));
+                ThreadPool::shared().parallel_for((count + CHUNK - 1) / CHUNK, [&](std::size_t c) {
+                    const std::size_t first = c * CHUNK, end = std::min(count, first + CHUNK);
+                    const std::uint64_t window_low = low + static_cast<std::uint64_t>(first), window_high = low + static_cast<std::uint64_t>(end - 1);
+                    std::vector<std::uint32_t> remaining(end - first);
+                    for (std::size_t i = 0; i < remaining.size(); i++) remaining[i] = static_cast<std::uint32_t>(window_low + i);
+                    for (std::uint64_t p : primes) {
+                        //multiples of p in the window, each divided by p until it no longer goes
+                        for (std::uint64_t m = (window_low + p - 1) / p * p; m <= window_high; m += p) {
+                            std::size_t i = static_cast<std::size_t>(m - window_low);
+                            std::uint32_t power = 1;
+                            int e = 0;
+                            do {
+                                remaining[i] /= static_cast<std::uint32_t>(p);
+                                power *= static_cast<std::uint32_t>(p);
+                                e++;
+                            } while (remaining[i] % p == 0);
+                            rtrn.totient[first + i] *= power - power / static_cast<std::uint32_t>(p);
+                            rtrn.mobius[first + i] = e == 1 ? static_cast<std::int8_t>(-rtrn.mobius[first + i]) : std::int8_t(0);
+                            rtrn.divisor_count[first + i] *= static_cast<std::uint16_t>(e + 1);
+                        }
+                    }
+                    //n has at most one prime factor above isqrt(high), to the first power
+                    for (std::size_t i = 0; i < remaining.size(); i++) {
+                        if (remaining[i] == 1) continue;
+                        rtrn.totient[first + i] *= remaining[i] - 1;
+                        rtrn.mobius[first + i] = static_cast<std::int8_t>(-rtrn.mobius[first + i]);
+                        rtrn.divisor_count[first + i] *= 2;
+                    }
+                }, concurrency);
+                return rtrn;
+            }
+
+        private:
+            //the unit of parallel work in arithmetic_functions() and segmented_arithmetic_functions()
+            static constexpr std::size_t CHUNK = std::size_t(1) << 16;
+
+            //visit(p, e, p^e) for every prime power exactly dividing n, in ascending order of p
+            template <typename Visit>
+            void for_each_prime_power(std::uint32_t n, Visit&& visit) const {
+                if (n % 2 == 0) {
+                    int e = std::countr_zero(n);
+                    visit(2u, e, std::uint32_t(1) << e);
+                    n >>= e;
+                }
+                while (n > 1) {
+                    std::uint32_t p = table[n / 2] == 0 ? n : table[n / 2];
+                    std::uint32_t power = 1;
+                    int e = 0;
+                    do {
+                        n /= p;
+                        power *= p;
+                        e++;
+                    } while (n % p == 0);
+                    visit(p, e, power);
+                }
+            }
+
+            std::uint32_t limit_;
+            //table[n / 2]: the smallest prime factor of odd n, 0 when n is prime (or 1)
+            std::vector<std::uint16_t> table;
+            std::vector<std::uint16_t> odd_primes;
+        };
+    }
+}
+
+#endif
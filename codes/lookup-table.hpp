@@ -0,0 +1,200 @@
+#ifndef UMJCUTIL_MATH_LOOKUP_TABLE_HPP
+#define UMJCUTIL_MATH_LOOKUP_TABLE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "cpu-dispatch.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief Func on [Func::LOWER, Func::UPPER] as equal pieces, each a polynomial of degree Degree
+         * a piece is the Chebyshev interpolant of Func::reference at Degree + 1 Chebyshev nodes, computed in long double
+         * and stored as power-series coefficients in t in [-1, 1]; with Degree = 7 one piece is one 64-byte cache line,
+         * so a lookup touches a single line. the constructor doubles the piece count until the error, measured against
+         * Func::reference at CHECKS_PER_PIECE points of every piece, is at most target_error.
+         * max_error() is that measured error plus the rounding of the Horner steps, and bounds |table(x) - f(x)| on the domain.
+         * Func: LOWER and UPPER as static constexpr double, and static long double reference(long double), as in table-functions.hpp.
+        */
+        template <typename Func, std::size_t Degree = 7>
+        class LookupTable {
+        public:
+            static constexpr std::size_t COEFFICIENTS = Degree + 1;
+            static constexpr std::size_t CHECKS_PER_PIECE = 64;
+            static constexpr std::size_t MAX_PIECES = std::size_t(1) << 20;
+            static constexpr double DEFAULT_TARGET_ERROR = 1e-14;
+
+            explicit LookupTable(double target_error = DEFAULT_TARGET_ERROR) {
+                static_assert(Func::LOWER < Func::UPPER, "the domain must not be empty");
+                if (!(target_error > 0.0)) throw std::invalid_argument("the target error must be positive");
+                for (std::size_t count = 1;; count *= 2) {
+                    build(count);
+                    if (bound <= target_error) break;
+                    if (count * 2 > MAX_PIECES) throw std::runtime_error("no table of at most MAX_PIECES pieces reaches the target error");
+                }
+            }
+
+            //built with DEFAULT_TARGET_ERROR on first use
+            static const LookupTable& shared() {
+                static const LookupTable rtrn;
+                return rtrn;
+            }
+
+            double lower() const { return Func::LOWER; }
+            double upper() const { return Func::UPPER; }
+            std::size_t pieces() const { return table.size(); }
+            double max_error() const { return bound; }
+
+            double operator()(double x) const {
+                return evaluate(x);
+            }
+            double evaluate(double x) const {
+                if (!(x >= Func::LOWER && x <= Func::UPPER)) throw std::domain_error("x is outside the table's domain");
+                return evaluate_unchecked(x);
+            }
+            //out[i] = f(x[i]), several lanes at a time with the kernel picked at runtime from what the CPU supports
+            void evaluate(std::span<const double> x, std::span<double> out) const {
+                if (x.size() != out.size()) throw std::invalid_argument("x and out differ in size");
+                bool inside = true;
+                for (double value : x) inside &= (value >= Func::LOWER) & (value <= Func::UPPER);
+                if (!inside) throw std::domain_error("x is outside the table's domain");
+#ifdef UMJCUTIL_CPU_DISPATCH_X86
+                switch (CpuDispatch::kernel()) {
+                case CpuDispatch::Kernel::avx512:
+                    evaluate_avx512(x.data(), out.data(), x.size());
+                    return;
+                case CpuDispatch::Kernel::avx2:
+                    evaluate_avx2(x.data(), out.data(), x.size());
+                    return;
+                default:
+                    break;
+                }
+#endif
+                evaluate_scalar(x.data(), out.data(), x.size());
+            }
+
+        private:
+            struct alignas(64) Piece {
+                double c[COEFFICIENTS]; //c[m] multiplies t^m
+            };
+            static constexpr std::size_t STRIDE = sizeof(Piece) / sizeof(double);
+
+            double evaluate_unchecked(double x) const {
+                double u = (x - Func::LOWER) * inverse_width;
+                double k = std::min(std::floor(u), last_piece);
+                double t = 2.0 * (u - k) - 1.0;
+                const double* c = table[static_cast<std::size_t>(k)].c;
+                double rtrn = c[Degree];
+                for (std::size_t m = Degree; m-- > 0;) rtrn = rtrn * t + c[m];
+                return rtrn;
+            }
+            void evaluate_scalar(const double* x, double* out, std::size_t count) const {
+                for (std::size_t i = 0; i < count; i++) out[i] = evaluate_unchecked(x[i]);
+            }
+
+#ifdef UMJCUTIL_CPU_DISPATCH_X86
+            //every lane finds its piece, then the Horner steps gather one coefficient per lane from the lanes' pieces.
+            //the masked forms of the intrinsics take a defined source, which keeps GCC 12 from warning about the plain ones' undefined one.
+            __attribute__((target("avx2")))
+            void evaluate_avx2(const double* x, double* out, std::size_t count) const {
+                const double* base = table.front().c;
+                const __m256d lower = _mm256_set1_pd(Func::LOWER), scale = _mm256_set1_pd(inverse_width), last = _mm256_set1_pd(last_piece);
+                const __m256d one = _mm256_set1_pd(1.0), two = _mm256_set1_pd(2.0);
+                const __m256d zero = _mm256_setzero_pd(), all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+                std::size_t i = 0;
+                for (; i + 4 <= count; i += 4) {
+                    __m256d u = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(x + i), lower), scale);
+                    __m256d k = _mm256_min_pd(_mm256_floor_pd(u), last);
+                    __m256d t = _mm256_sub_pd(_mm256_mul_pd(two, _mm256_sub_pd(u, k)), one);
+                    //pieces stay below 2^20, so the 32-bit offsets of their first coefficients cannot overflow
+                    __m128i offset = _mm_mullo_epi32(_mm256_cvttpd_epi32(k), _mm_set1_epi32(static_cast<int>(STRIDE)));
+                    __m256d rtrn = _mm256_mask_i32gather_pd(zero, base + Degree, offset, all, 8);
+                    for (std::size_t m = Degree; m-- > 0;) rtrn = _mm256_add_pd(_mm256_mul_pd(rtrn, t), _mm256_mask_i32gather_pd(zero, base + m, offset, all, 8));
+                    _mm256_storeu_pd(out + i, rtrn);
+                }
+                evaluate_scalar(x + i, out + i, count - i);
+            }
+            __attribute__((target("avx512f,avx512dq")))
+            void evaluate_avx512(const double* x, double* out, std::size_t count) const {
+                const double* base = table.front().c;
+                const __m512d lower = _mm512_set1_pd(Func::LOWER), scale = _mm512_set1_pd(inverse_width), last = _mm512_set1_pd(last_piece);
+                const __m512d one = _mm512_set1_pd(1.0), two = _mm512_set1_pd(2.0);
+                std::size_t i = 0;
+                for (; i + 8 <= count; i += 8) {
+                    __m512d u = _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i), lower), scale);
+                    __m512d k = _mm512_maskz_min_pd(0xFF, _mm512_maskz_roundscale_pd(0xFF, u, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC), last);
+                    __m512d t = _mm512_sub_pd(_mm512_mul_pd(two, _mm512_sub_pd(u, k)), one);
+                    __m512i offset = _mm512_mullo_epi64(_mm512_cvttpd_epi64(k), _mm512_set1_epi64(static_cast<long long>(STRIDE)));
+                    __m512d rtrn = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xFF, offset, base + Degree, 8);
+                    for (std::size_t m = Degree; m-- > 0;) rtrn = _mm512_add_pd(_mm512_mul_pd(rtrn, t), _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xFF, offset, base + m, 8));
+                    _mm512_storeu_pd(out + i, rtrn);
+                }
+                evaluate_scalar(x + i, out + i, count - i);
+            }
+#endif
+
+            void build(std::size_t count) {
+                table.assign(count, Piece{});
+                const long double lower = Func::LOWER, width = (static_cast<long double>(Func::UPPER) - lower) / count;
+                inverse_width = static_cast<double>(count / (static_cast<long double>(Func::UPPER) - lower));
+                last_piece = static_cast<double>(count - 1);
+                long double node_value[COEFFICIENTS], node_t[COEFFICIENTS];
+                for (std::size_t p = 0; p < count; p++) {
+                    //Chebyshev coefficients a_n = (2 / N) sum_j f(t_j) T_n(t_j) at the nodes t_j = cos(pi (j + 1/2) / N)
+                    for (std::size_t j = 0; j < COEFFICIENTS; j++) {
+                        node_t[j] = std::cos(std::numbers::pi_v<long double> * (j + 0.5L) / COEFFICIENTS);
+                        node_value[j] = Func::reference(lower + width * (p + (node_t[j] + 1.0L) / 2.0L));
+                    }
+                    long double chebyshev[COEFFICIENTS];
+                    for (std::size_t n = 0; n < COEFFICIENTS; n++) {
+                        long double sum = 0.0L;
+                        for (std::size_t j = 0; j < COEFFICIENTS; j++) sum += node_value[j] * std::cos(std::numbers::pi_v<long double> * n * (j + 0.5L) / COEFFICIENTS);
+                        chebyshev[n] = 2.0L * sum / COEFFICIENTS;
+                    }
+                    chebyshev[0] /= 2.0L;
+                    //to powers of t, with T_{n+1} = 2t T_n - T_{n-1} kept as power-series coefficients
+                    long double power[COEFFICIENTS] = {}, previous[COEFFICIENTS] = {}, current[COEFFICIENTS] = {};
+                    previous[0] = 1.0L; //T_0
+                    current[1] = 1.0L; //T_1
+                    for (std::size_t n = 0; n < COEFFICIENTS; n++) {
+                        const long double* t_n = n == 0 ? previous : current;
+                        for (std::size_t m = 0; m < COEFFICIENTS; m++) power[m] += chebyshev[n] * t_n[m];
+                        if (n == 0) continue;
+                        long double next[COEFFICIENTS] = {};
+                        for (std::size_t m = 0; m + 1 < COEFFICIENTS; m++) next[m + 1] = 2.0L * current[m];
+                        for (std::size_t m = 0; m < COEFFICIENTS; m++) next[m] -= previous[m];
+                        std::copy(current, current + COEFFICIENTS, previous);
+                        std::copy(next, next + COEFFICIENTS, current);
+                    }
+                    for (std::size_t m = 0; m < COEFFICIENTS; m++) table[p].c[m] = static_cast<double>(power[m]);
+                }
+                //the error at evenly spread points of every piece, both ends included, against the long double reference
+                long double measured = 0.0L, largest = 0.0L;
+                for (std::size_t p = 0; p < count; p++) {
+                    for (std::size_t j = 0; j <= CHECKS_PER_PIECE; j++) {
+                        double x = static_cast<double>(lower + width * (p + static_cast<long double>(j) / CHECKS_PER_PIECE));
+                        x = std::clamp(x, Func::LOWER, Func::UPPER);
+                        long double exact = Func::reference(x);
+                        measured = std::max(measured, std::fabs(evaluate_unchecked(x) - exact));
+                        largest = std::max(largest, std::fabs(exact));
+                    }
+                }
+                //each Horner step rounds once or twice, and a kernel may fuse them differently: allow an ulp per step
+                bound = static_cast<double>(measured + 2.0L * COEFFICIENTS * std::numeric_limits<double>::epsilon() * largest);
+            }
+
+            std::vector<Piece> table;
+            double inverse_width = 0.0;
+            double last_piece = 0.0;
+            double bound = 0.0;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef UMJCUTIL_MATH_MILLER_RABIN_HPP
+#define UMJCUTIL_MATH_MILLER_RABIN_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "montgomery.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        namespace MillerRabin {
+            //these bases have no strong pseudoprime in common below 2^32 (Jaeschke) and below 2^64 (Sinclair) respectively.
+            inline constexpr std::array<std::uint64_t, 3> BASES_32 = { 2, 7, 61 };
+            inline constexpr std::array<std::uint64_t, 7> BASES_64 = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+            //trial division by these first rejects most composites for less than one modular power.
+            inline constexpr std::array<std::uint64_t, 15> SMALL_PRIMES = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47 };
+
+            //strong probable prime test of odd n > 2 to base a, everything in Montgomery form
+            inline bool is_strong_probable_prime(const Montgomery64& mont, std::uint64_t a) {
+                std::uint64_t n = mont.modulus();
+                a %= n;
+                if (a == 0) return true;
+                int s = std::countr_zero(n - 1);
+                std::uint64_t d = (n - 1) >> s;
+                std::uint64_t one = mont.one();
+                std::uint64_t minus_one = mont.subtract(0, one);
+                std::uint64_t x = mont.power(mont.to(a), d);
+                if (x == one || x == minus_one) return true;
+                for (int r = 1; r < s; r++) {
+                    x = mont.multiply(x, x);
+                    if (x == minus_one) return true;
+                    if (x == one) return false;
+                }
+                return false;
+            }
+
+            /**
+             * @brief deterministic primality test for every 64-bit n
+             * a handful of small trial divisions, then Miller-Rabin over a fixed set of bases known to admit no pseudoprime.
+            */
+            inline bool is_prime(std::uint64_t n) {
+                if (n < 2) return false;
+                for (std::uint64_t p : SMALL_PRIMES) {
+                    if (n % p == 0) return n == p;
+                }
+                if (n < SMALL_PRIMES.back() * SMALL_PRIMES.back()) return true;
+                Montgomery64 mont(n);
+                if (n >> 32 == 0) {
+                    for (std::uint64_t a : BASES_32) {
+                        if (!is_strong_probable_prime(mont, a)) return false;
+                    }
+                    return true;
+                }
+                for (std::uint64_t a : BASES_64) {
+                    if (!is_strong_probable_prime(mont, a)) return false;
+                }
+                return true;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef UMJCUTIL_MATH_MONTGOMERY_HPP
+#define UMJCUTIL_MATH_MONTGOMERY_HPP
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief Montgomery arithmetic modulo an odd 64-bit modulus
+         * residues are kept as a * 2^64 mod n, so a modular product costs two 64x64->128 multiplies and no division.
+        */
+        class Montgomery64 {
+        public:
+            explicit Montgomery64(std::uint64_t modulus) : n(modulus) {
+                if (modulus % 2 == 0) throw std::domain_error("Montgomery form needs an odd modulus");
+                //Newton iteration for n^-1 mod 2^64; n * n == 1 (mod 8) gives 3 correct bits and every step doubles them
+                inverse = modulus;
+                for (int i = 0; i < 5; i++) inverse *= 2 - modulus * inverse;
+                r2 = static_cast<std::uint64_t>(-static_cast<unsigned __int128>(modulus) % modulus);
+            }
+
+            std::uint64_t modulus() const { return n; }
+
+            //a * 2^-64 mod n for a < n * 2^64.
+            //with m = a * n^-1 mod 2^64 the low words of a and m * n agree, so only the high words need subtracting.
+            std::uint64_t reduce(unsigned __int128 a) const {
+                std::uint64_t m = static_cast<std::uint64_t>(a) * inverse;
+                std::uint64_t a_high = static_cast<std::uint64_t>(a >> 64);
+                std::uint64_t mn_high = static_cast<std::uint64_t>((static_cast<unsigned __int128>(m) * n) >> 64);
+                return a_high >= mn_high ? a_high - mn_high : a_high - mn_high + n;
+            }
+            std::uint64_t to(std::uint64_t a) const { return multiply(a % n, r2); }
+            std::uint64_t from(std::uint64_t a) const { return reduce(a); }
+            std::uint64_t one() const { return to(1); }
+
+            std::uint64_t multiply(std::uint64_t a, std::uint64_t b) const {
+                return reduce(static_cast<unsigned __int128>(a) * b);
+            }
+            std::uint64_t add(std::uint64_t a, std::uint64_t b) const {
+                std::uint64_t rtrn = a + b;
+                return (rtrn < a || rtrn >= n) ? rtrn - n : rtrn;
+            }
+            std::uint64_t subtract(std::uint64_t a, std::uint64_t b) const {
+                return a >= b ? a - b : a + (n - b);
+            }
+            //base in Montgomery form, result in Montgomery form
+            std::uint64_t power(std::uint64_t base, std::uint64_t exponent) const {
+                std::uint64_t rtrn = one();
+                while (exponent) {
+                    if (exponent & 1) rtrn = multiply(rtrn, base);
+                    base = multiply(base, base);
+                    exponent >>= 1;
+                }
+                return rtrn;
+            }
+
+        private:
+            std::uint64_t n;
+            std::uint64_t inverse; //n^-1 mod 2^64
+            std::uint64_t r2; //2^128 mod n
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef UMJCUTIL_MATH_POLLARD_RHO_HPP
+#define UMJCUTIL_MATH_POLLARD_RHO_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "montgomery.hpp"
+#include "miller-rabin.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        namespace PollardRho {
+            //|x - y| is multiplied into one product for this many steps before taking a single gcd
+            inline constexpr std::uint64_t GCD_BATCH = 128;
+
+            /**
+             * @brief a nontrivial divisor of an odd composite n by Brent's variant of Pollard's rho
+             * iterates x -> x^2 + c in Montgomery form; when a batch ends at gcd n it backtracks one step at a time from the batch start.
+            */
+            inline std::uint64_t find_divisor(std::uint64_t n) {
+                Montgomery64 mont(n);
+                for (std::uint64_t c = 1;; c++) {
+                    std::uint64_t increment = mont.to(c);
+                    auto f = [&](std::uint64_t v) { return mont.add(mont.multiply(v, v), increment); };
+                    auto distance = [](std::uint64_t a, std::uint64_t b) { return a > b ? a - b : b - a; };
+                    std::uint64_t x = 0, y = mont.to(2), saved = 0;
+                    std::uint64_t product = mont.one();
+                    std::uint64_t g = 1;
+                    for (std::uint64_t r = 1; g == 1; r *= 2) {
+                        x = y;
+                        for (std::uint64_t i = 0; i < r; i++) y = f(y);
+                        for (std::uint64_t k = 0; k < r && g == 1; k += GCD_BATCH) {
+                            saved = y;
+                            for (std::uint64_t i = 0; i < std::min(GCD_BATCH, r - k); i++) {
+                                y = f(y);
+                                product = mont.multiply(product, distance(x, y));
+                            }
+                            //the product and the differences are scaled by 2^64, which is coprime to n, so the gcd is unaffected
+                            g = std::gcd(product, n);
+                        }
+                    }
+                    if (g == n) {
+                        do {
+                            saved = f(saved);
+                            g = std::gcd(distance(x, saved), n);
+                        } while (g == 1);
+                    }
+                    if (g != n) return g;
+                    //the cycle closed without splitting n; try another polynomial
+                }
+            }
+
+            //appends the prime factors of odd n (with multiplicity, unordered) to out
+            inline void factor_into(std::uint64_t n, std::vector<std::uint64_t>& out) {
+                if (n == 1) return;
+                if (MillerRabin::is_prime(n)) {
+                    out.push_back(n);
+                    return;
+                }
+                std::uint64_t d = find_divisor(n);
+                factor_into(d, out);
+                factor_into(n / d, out);
+            }
+        }
+    }
+}
+
+#endif
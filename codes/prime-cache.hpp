@@ -0,0 +1,244 @@
+#ifndef UMJCUTIL_MATH_PRIME_CACHE_HPP
+#define UMJCUTIL_MATH_PRIME_CACHE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief ascending prime list that many threads read without locking while one thread at a time extends it
+         * primes live in blocks that double in size and are never moved or freed, so a published element stays where it is.
+         * a writer appends past the published end and then publishes a new generation (count, limit) with one atomic store;
+         * readers load the current generation once and see an immutable snapshot of every prime up to its limit.
+        */
+        template <typename T>
+        class PrimeCache {
+        private:
+            struct Generation {
+                std::size_t count;
+                T limit;
+            };
+            static constexpr std::size_t FIRST_BLOCK_SHIFT = 10;
+            static constexpr std::size_t MAX_BLOCKS = 54;
+
+            //element i lives in block k = floor(log2(i / FIRST_BLOCK + 1)) at offset i - FIRST_BLOCK * (2^k - 1)
+            static constexpr std::size_t block_of(std::size_t i) {
+                return std::bit_width((i >> FIRST_BLOCK_SHIFT) + 1) - 1;
+            }
+            static constexpr std::size_t block_begin(std::size_t k) {
+                return ((std::size_t(1) << k) - 1) << FIRST_BLOCK_SHIFT;
+            }
+
+        public:
+            /**
+             * @brief immutable view of the primes up to limit() as published at the time it was taken
+             * stays valid, and unchanged, however far the cache is extended afterwards.
+            */
+            class Snapshot {
+            public:
+                class iterator {
+                public:
+                    using iterator_category = std::random_access_iterator_tag;
+                    using value_type = T;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = const T*;
+                    using reference = const T&;
+
+                    iterator() = default;
+                    iterator(const PrimeCache* cache, std::size_t index) : cache(cache), index(index) {}
+                    reference operator*() const { return cache->at(index); }
+                    reference operator[](difference_type n) const { return cache->at(index + n); }
+                    iterator& operator++() { index++; return *this; }
+                    iterator operator++(int) { iterator rtrn = *this; index++; return rtrn; }
+                    iterator& operator--() { index--; return *this; }
+                    iterator operator--(int) { iterator rtrn = *this; index--; return rtrn; }
+                    iterator& operator+=(difference_type n) { index += n; return *this; }
+                    iterator& operator-=(difference_type n) { index -= n; return *this; }
+                    friend iterator operator+(iterator it, difference_type n) { return it += n; }
+                    friend iterator operator+(difference_type n, iterator it) { return it += n; }
+                    friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+                    friend difference_type operator-(const iterator& a, const iterator& b) { return difference_type(a.index) - difference_type(b.index); }
+                    friend bool operator==(const iterator& a, const iterator& b) { return a.index == b.index; }
+                    friend auto operator<=>(const iterator& a, const iterator& b) { return a.index <=> b.index; }
+
+                private:
+                    const PrimeCache* cache = nullptr;
+                    std::size_t index = 0;
+                };
+
+                Snapshot(const PrimeCache* cache, const Generation* generation) : cache(cache), generation(generation) {}
+                iterator begin() const { return iterator(cache, 0); }
+                iterator end() const { return iterator(cache, generation->count); }
+                std::size_t size() const { return generation->count; }
+                const T& operator[](std::size_t i) const { return cache->at(i); }
+                const T& back() const { return cache->at(generation->count - 1); }
+                //every prime up to limit() is in the snapshot
+                T limit() const { return generation->limit; }
+                //the first prime > value, or end()
+                iterator upper_bound(T value) const { return std::upper_bound(begin(), end(), value); }
+
+            private:
+                const PrimeCache* cache;
+                const Generation* generation;
+            };
+
+            //initial: every prime up to limit
+            PrimeCache(std::initializer_list<T> initial, T limit) : PrimeCache(initial.begin(), initial.end(), limit) {}
+            template <typename Iterator>
+            PrimeCache(Iterator first, Iterator last, T limit) {
+                std::size_t count = 0;
+                for (; first != last; ++first) write(count++, static_cast<T>(*first));
+                generations.push_back({ count, limit });
+                current.store(&generations.back(), std::memory_order_release);
+            }
+            PrimeCache(const PrimeCache&) = delete;
+            PrimeCache& operator=(const PrimeCache&) = delete;
+
+            //lock-free and wait-free
+            Snapshot snapshot() const {
+                return Snapshot(this, current.load(std::memory_order_acquire));
+            }
+            T limit() const {
+                return current.load(std::memory_order_acquire)->limit;
+            }
+
+            //bytes of the blocks holding the published primes
+            std::size_t allocated_bytes() const {
+                std::size_t count = current.load(std::memory_order_acquire)->count;
+                return count == 0 ? 0 : block_begin(block_of(count - 1) + 1) * sizeof(T);
+            }
+
+            /**
+             * @brief extends the cache to new_limit unless someone got there first; returns whether this call extended it
+             * producer(snapshot, out) gets the primes up to the current limit and must append, in order, every prime in (snapshot.limit(), new_limit] to out.
+             * writers are serialized; readers are never blocked, and only see the new primes once all of them are in place.
+             * @param waited_nanoseconds: when not nullptr, set to how long the writer lock was waited for, 0 if it was free
+            */
+            template <typename Producer>
+            bool extend(T new_limit, Producer&& producer, std::uint64_t* waited_nanoseconds = nullptr) {
+                std::unique_lock<std::mutex> writer_lock(writer_mutex, std::defer_lock);
+                if (waited_nanoseconds == nullptr) writer_lock.lock();
+                else if (writer_lock.try_lock()) *waited_nanoseconds = 0;
+                else {
+                    auto start = std::chrono::steady_clock::now();
+                    writer_lock.lock();
+                    *waited_nanoseconds = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+                }
+                Snapshot base = snapshot();
+                if (new_limit <= base.limit()) return false;
+                std::size_t count = base.size();
+                Appender out(*this, count);
+                producer(base, out);
+                generations.push_back({ count, new_limit });
+                current.store(&generations.back(), std::memory_order_release);
+                return true;
+            }
+
+            //output handed to extend()'s producer
+            class Appender {
+            public:
+                using value_type = T;
+                Appender(PrimeCache& cache, std::size_t& count) : cache(cache), count(count) {}
+                void push_back(const T& value) { cache.write(count++, value); }
+
+            private:
+                PrimeCache& cache;
+                std::size_t& count;
+            };
+
+        private:
+            const T& at(std::size_t i) const {
+                std::size_t k = block_of(i);
+                return blocks[k][i - block_begin(k)];
+            }
+            //writer only, past the published end
+            void write(std::size_t i, const T& value) {
+                std::size_t k = block_of(i);
+                if (!blocks[k]) blocks[k] = std::make_unique<T[]>(std::size_t(1) << (k + FIRST_BLOCK_SHIFT));
+                blocks[k][i - block_begin(k)] = value;
+            }
+
+            std::array<std::unique_ptr<T[]>, MAX_BLOCKS> blocks;
+            //every generation ever published stays alive, since a reader may still hold it; a deque never moves its elements
+            std::deque<Generation> generations;
+            std::atomic<const Generation*> current;
+            std::mutex writer_mutex;
+        };
+
+        /**
+         * @brief a PrimeCache<Stored>::Snapshot read as values of T, cut at the largest T
+         * lets caches of every width share one store of narrow values: the elements are converted as they are read.
+        */
+        template <typename T, typename Stored>
+        class TypedSnapshot {
+        public:
+            using Base = typename PrimeCache<Stored>::Snapshot;
+
+            class iterator {
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = T;
+
+                iterator() = default;
+                explicit iterator(typename Base::iterator at) : at(at) {}
+                T operator*() const { return static_cast<T>(*at); }
+                T operator[](difference_type n) const { return static_cast<T>(at[n]); }
+                iterator& operator++() { ++at; return *this; }
+                iterator operator++(int) { iterator rtrn = *this; ++at; return rtrn; }
+                iterator& operator--() { --at; return *this; }
+                iterator operator--(int) { iterator rtrn = *this; --at; return rtrn; }
+                iterator& operator+=(difference_type n) { at += n; return *this; }
+                iterator& operator-=(difference_type n) { at -= n; return *this; }
+                friend iterator operator+(iterator it, difference_type n) { return it += n; }
+                friend iterator operator+(difference_type n, iterator it) { return it += n; }
+                friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+                friend difference_type operator-(const iterator& a, const iterator& b) { return a.at - b.at; }
+                friend bool operator==(const iterator& a, const iterator& b) { return a.at == b.at; }
+                friend auto operator<=>(const iterator& a, const iterator& b) { return a.at <=> b.at; }
+
+            private:
+                typename Base::iterator at;
+            };
+
+            explicit TypedSnapshot(Base base) : base(base), count(base.size()), limit_(0) {
+                //a T narrower than Stored sees the primes up to its own maximum only
+                if (static_cast<std::uint64_t>(std::numeric_limits<T>::max()) < static_cast<std::uint64_t>(base.limit())) {
+                    count = static_cast<std::size_t>(base.upper_bound(static_cast<Stored>(std::numeric_limits<T>::max())) - base.begin());
+                    limit_ = std::numeric_limits<T>::max();
+                }
+                else limit_ = static_cast<T>(base.limit());
+            }
+            iterator begin() const { return iterator(base.begin()); }
+            iterator end() const { return iterator(base.begin() + static_cast<std::ptrdiff_t>(count)); }
+            std::size_t size() const { return count; }
+            T operator[](std::size_t i) const { return static_cast<T>(base[i]); }
+            T back() const { return static_cast<T>(base[count - 1]); }
+            //every prime up to limit() is in the snapshot
+            T limit() const { return limit_; }
+            //the first prime > value, or end()
+            iterator upper_bound(T value) const { return std::upper_bound(begin(), end(), value); }
+
+        private:
+            Base base;
+            std::size_t count;
+            T limit_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,251 @@
+#ifndef UMJCUTIL_MATH_PRIME_COUNTING_HPP
+#define UMJCUTIL_MATH_PRIME_COUNTING_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "isqrt.hpp"
+#include "sieve.hpp"
+#include "thread-pool.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief read-only pi(v) and primality lookups over a mod-30 wheel bitmap of [0, limit]
+         * checkpoints[c] counts the primes above 5 in the first c * stride bytes; stride is a multiple of 8.
+         * does not own its memory, so the same lookups serve an in-memory PiTable and a memory-mapped table file.
+        */
+        class WheelIndex {
+        public:
+            WheelIndex() = default;
+            WheelIndex(const std::uint8_t* bitmap, const std::uint64_t* checkpoints, std::size_t stride, std::uint64_t limit)
+                : bitmap(bitmap), checkpoints(checkpoints), stride(stride), index_limit(limit) {
+                if (stride == 0 || stride % 8 != 0) throw std::invalid_argument("the checkpoint stride must be a positive multiple of 8 bytes");
+            }
+
+            std::uint64_t limit() const { return index_limit; }
+
+            std::uint64_t pi(std::uint64_t v) const {
+                if (v > index_limit) throw std::out_of_range("the value exceeds the range of the pi table");
+                if (v < 7) return SMALL_PI[v];
+                std::uint64_t byte = v / 30;
+                std::uint64_t c = byte / stride;
+                std::uint64_t w = byte / 8;
+                std::uint64_t rtrn = 3 + checkpoints[c];
+                for (std::uint64_t i = c * stride / 8; i < w; i++) rtrn += std::popcount(word(i));
+                //keep the bytes of this word below `byte`, then the bits of `byte` up to v
+                std::uint64_t mask = (std::uint64_t(1) << (8 * (byte % 8))) - 1;
+                mask |= std::uint64_t(Wheel30::mask_up_to(v % 30)) << (8 * (byte % 8));
+                return rtrn + std::popcount(word(w) & mask);
+            }
+
+            bool is_prime(std::uint64_t v) const {
+                if (v > index_limit) throw std::out_of_range("the value exceeds the range of the pi table");
+                if (v < 7) return v == 2 || v == 3 || v == 5;
+                return bitmap[v / 30] & Wheel30::BIT_OF[v % 30];
+            }
+
+            //calls callback(p) for every prime in [low, min(high, limit())] in ascending order
+            template <typename Callback>
+            void for_each_prime(std::uint64_t low, std::uint64_t high, Callback&& callback) const {
+                high = std::min(high, index_limit);
+                for (std::uint64_t p : { 2, 3, 5 }) {
+                    if (low <= p && p <= high) callback(p);
+                }
+                if (low > high) return;
+                for (std::uint64_t byte = low / 30; byte <= high / 30; byte++) {
+                    std::uint32_t bits = bitmap[byte];
+                    if (byte == low / 30) bits &= Wheel30::mask_from(low % 30);
+                    if (byte == high / 30) bits &= Wheel30::mask_up_to(high % 30);
+                    while (bits) {
+                        callback(byte * 30 + Wheel30::RESIDUES[std::countr_zero(bits)]);
+                        bits &= bits - 1;
+                    }
+                }
+            }
+
+            //the bitmap word of bytes [8w, 8w + 8), byte i in bits [8i, 8i + 8) whatever the endianness
+            std::uint64_t word(std::size_t w) const {
+                std::uint64_t rtrn;
+                std::memcpy(&rtrn, bitmap + 8 * w, sizeof(rtrn));
+                if constexpr (std::endian::native == std::endian::big) rtrn = __builtin_bswap64(rtrn);
+                return rtrn;
+            }
+
+        private:
+            static constexpr std::array<std::uint8_t, 7> SMALL_PI = { 0, 0, 1, 2, 2, 3, 3 };
+            const std::uint8_t* bitmap = nullptr;
+            const std::uint64_t* checkpoints = nullptr;
+            std::size_t stride = 8;
+            std::uint64_t index_limit = 0;
+        };
+
+        /**
+         * @brief pi(v) for every v up to a limit in O(1)
+         * a mod-30 wheel bitmap of [0, limit] with a prime count checkpoint every 8 bytes (240 integers).
+        */
+        class PiTable {
+        public:
+            PiTable() = default;
+            //base primes: every prime up to isqrt(limit)
+            //the bitmap is sieved in slices on the shared thread pool, using at most `concurrency` threads (0 for the pool's setting)
+            template <typename Iterator>
+            PiTable(std::uint64_t limit, Iterator base_first, Iterator base_last, std::size_t concurrency = 0) {
+                std::size_t bytes = static_cast<std::size_t>(limit / 30 + 1);
+                std::size_t words = bytes / 8 + 1;
+                bitmap.assign(words * 8, 0);
+                //slices start on a wheel byte, so no two of them write the same byte
+                std::uint64_t slice_bytes = std::uint64_t(SegmentedSieve::segment_bytes_for(limit)) * 4;
+                ThreadPool::shared().parallel_for(static_cast<std::size_t>((bytes - 1) / slice_bytes + 1), [&](std::size_t s) {
+                    std::uint64_t first = s * slice_bytes * 30;
+                    SegmentedSieve sieve(first, std::min(limit, first + slice_bytes * 30 - 1), base_first, base_last);
+                    while (sieve.next_segment()) {
+                        std::memcpy(bitmap.data() + sieve.segment_first_byte(), sieve.segment_data(), sieve.segment_bytes());
+                    }
+                }, concurrency);
+                checkpoints.resize(words + 1);
+                index = WheelIndex(bitmap.data(), checkpoints.data(), 8, limit);
+                checkpoints[0] = 0;
+                for (std::size_t w = 0; w < words; w++) checkpoints[w + 1] = checkpoints[w] + std::popcount(index.word(w));
+            }
+            //the index points into the vectors, whose buffers survive a move but not a copy
+            PiTable(PiTable&&) = default;
+            PiTable& operator=(PiTable&&) = default;
+            PiTable(const PiTable&) = delete;
+            PiTable& operator=(const PiTable&) = delete;
+
+            std::uint64_t limit() const { return index.limit(); }
+            std::uint64_t operator()(std::uint64_t v) const { return index.pi(v); }
+            bool is_prime(std::uint64_t v) const { return index.is_prime(v); }
+
+        private:
+            std::vector<std::uint8_t> bitmap;
+            std::vector<std::uint64_t> checkpoints;
+            WheelIndex index;
+        };
+
+        /**
+         * @brief Meissel-Lehmer prime counting
+         * pi(x) = phi(x, a) + a - 1 - P2(x, a) with a = pi(cbrt(x)).
+         * phi(v, b) is cut off with periodic tables for the first few primes and with pi(v) - b + 1 once p_(b+1)^2 > v,
+         * and P2 and the cut-offs look pi up in a PiTable up to x^(2/3), so time and memory are about O(x^(2/3)).
+        */
+        class MeisselLehmer {
+        public:
+            //primes: ascending, and must contain every prime up to isqrt(x)
+            //concurrency: threads for building the pi table, 0 for the shared pool's setting
+            template <typename Iterator>
+            static std::uint64_t pi(std::uint64_t x, Iterator primes_first, Iterator primes_last, std::size_t concurrency = 0) {
+                if (x < 2) return 0;
+                std::uint64_t y = icbrt(x);
+                std::uint64_t root = isqrt(x);
+                MeisselLehmer engine(x / y, primes_first, primes_last, root, concurrency);
+                if (engine.primes.size() - 1 < engine.count(root)) throw std::invalid_argument("the prime list does not reach isqrt(x)");
+                std::size_t a = static_cast<std::size_t>(engine.count(y));
+                std::size_t b = static_cast<std::size_t>(engine.count(root));
+                std::uint64_t p2 = 0;
+                for (std::size_t i = a + 1; i <= b; i++) p2 += engine.count(x / engine.primes[i]) - (i - 1);
+                return engine.phi(x, a) + a - 1 - p2;
+            }
+
+        private:
+            //phi(v, b) for b <= SMALL_A comes straight from a table periodic in 2 * 3 * 5 * 7 * 11 * 13
+            static constexpr std::size_t SMALL_A = 6;
+            //phi(v, b) for v < CACHE_LIMIT and b < CACHE_A is memoized, one lazily allocated row per b
+            static constexpr std::uint64_t CACHE_LIMIT = std::uint64_t(1) << 16;
+            static constexpr std::size_t CACHE_A = 128;
+
+            struct SmallPhi {
+                std::array<std::uint32_t, SMALL_A + 1> period = {};
+                std::array<std::uint32_t, SMALL_A + 1> totient = {};
+                std::array<std::vector<std::uint16_t>, SMALL_A + 1> table;
+                SmallPhi() {
+                    constexpr std::array<std::uint32_t, SMALL_A> SMALL_PRIMES = { 2, 3, 5, 7, 11, 13 };
+                    period[0] = 1;
+                    totient[0] = 1;
+                    table[0] = { 0 };
+                    for (std::size_t b = 1; b <= SMALL_A; b++) {
+                        period[b] = period[b - 1] * SMALL_PRIMES[b - 1];
+                        totient[b] = totient[b - 1] * (SMALL_PRIMES[b - 1] - 1);
+                        table[b].resize(period[b]);
+                        std::uint16_t count = 0;
+                        for (std::uint32_t r = 0; r < period[b]; r++) {
+                            bool coprime = r != 0;
+                            for (std::size_t i = 0; i < b && coprime; i++) coprime = r % SMALL_PRIMES[i] != 0;
+                            if (coprime) count++;
+                            table[b][r] = count;
+                        }
+                    }
+                }
+            };
+            static const SmallPhi& small_phi() {
+                static const SmallPhi rtrn;
+                return rtrn;
+            }
+
+            template <typename Iterator>
+            MeisselLehmer(std::uint64_t table_limit, Iterator primes_first, Iterator primes_last, std::uint64_t root, std::size_t concurrency) : small(small_phi()) {
+                //1-based, so that primes[i] is p_i
+                primes.push_back(0);
+                for (; primes_first != primes_last; ++primes_first) {
+                    std::uint64_t p = static_cast<std::uint64_t>(*primes_first);
+                    primes.push_back(p);
+                    if (p > root) break;
+                }
+                table = PiTable(table_limit, primes.begin() + 1, primes.end(), concurrency);
+            }
+
+            std::uint64_t count(std::uint64_t v) const {
+                return table(v);
+            }
+
+            std::uint64_t phi(std::uint64_t v, std::size_t b) const {
+                if (b <= SMALL_A) return (v / small.period[b]) * small.totient[b] + small.table[b][v % small.period[b]];
+                if (v <= table.limit() && b + 1 < primes.size() && primes[b + 1] * primes[b + 1] > v) {
+                    //only 1 and the primes in (p_b, v] survive
+                    std::uint64_t pi_v = count(v);
+                    return pi_v >= b ? pi_v - b + 1 : 1;
+                }
+                bool cacheable = v < CACHE_LIMIT && b < CACHE_A;
+                if (cacheable) {
+                    if (cache[b].empty()) cache[b].resize(CACHE_LIMIT, 0);
+                    //phi(v, b) >= 1 for v >= 1, so 0 marks a slot not computed yet
+                    if (cache[b][v] != 0) return cache[b][v];
+                }
+                std::uint64_t rtrn = phi(v, SMALL_A);
+                for (std::size_t i = SMALL_A + 1; i <= b; i++) {
+                    std::uint64_t p = primes[i];
+                    if (p * p > v) {
+                        //phi(v / p_j, j - 1) is 1 for every remaining p_j <= v, and 0 once p_j > v
+                        std::uint64_t pi_v = count(v);
+                        if (pi_v >= i) rtrn -= std::min<std::uint64_t>(pi_v, b) - i + 1;
+                        break;
+                    }
+                    rtrn -= phi(v / p, i - 1);
+                }
+                if (cacheable) cache[b][v] = static_cast<std::uint16_t>(rtrn);
+                return rtrn;
+            }
+
+            static std::uint64_t icbrt(std::uint64_t x) {
+                std::uint64_t rtrn = static_cast<std::uint64_t>(std::cbrt(static_cast<double>(x)));
+                //the estimate is off by at most one; cbrt(2^64) < 2^22, so the cubes below cannot overflow
+                while (rtrn * rtrn * rtrn > x) rtrn--;
+                while ((rtrn + 1) * (rtrn + 1) * (rtrn + 1) <= x) rtrn++;
+                return rtrn;
+            }
+
+            const SmallPhi& small;
+            std::vector<std::uint64_t> primes;
+            PiTable table;
+            mutable std::array<std::vector<std::uint16_t>, CACHE_A> cache;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef UMJCUTIL_MATH_PRIME_RANGE_HPP
+#define UMJCUTIL_MATH_PRIME_RANGE_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include "sieve.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief the primes of [low, high] in ascending order, as a single-pass C++20 range over a segmented sieve
+         * one segment is sieved at a time and its primes are read straight off the wheel bits, so memory stays at
+         * one segment plus the sieving primes up to isqrt(high) however wide the interval is, and starting at low = 10^15
+         * costs nothing more than starting at 0. like std::ranges::istream_view, begin() may be called once and the range must not move afterwards.
+        */
+        template <typename T>
+        class PrimeRange : public std::ranges::view_interface<PrimeRange<T>> {
+        public:
+            class iterator {
+            public:
+                using iterator_concept = std::input_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+
+                iterator() = default;
+                explicit iterator(PrimeRange* range) : range(range) {}
+                T operator*() const { return range->current; }
+                iterator& operator++() {
+                    range->advance();
+                    return *this;
+                }
+                void operator++(int) { ++*this; }
+                bool operator==(std::default_sentinel_t) const { return range->done; }
+
+            private:
+                PrimeRange* range = nullptr;
+            };
+
+            //base: every prime up to isqrt(high), in ascending order
+            template <typename Iterator>
+            PrimeRange(std::uint64_t low, std::uint64_t high, Iterator base_first, Iterator base_last) : sieve(low, high, base_first, base_last) {
+                //the wheel leaves out 2, 3 and 5
+                for (std::uint64_t p : { 2, 3, 5 }) {
+                    if (low <= p && p <= high) small[small_count++] = p;
+                }
+            }
+
+            iterator begin() {
+                advance();
+                return iterator(this);
+            }
+            std::default_sentinel_t end() const { return std::default_sentinel; }
+
+        private:
+            void advance() {
+                if (small_next < small_count) {
+                    current = static_cast<T>(small[small_next++]);
+                    return;
+                }
+                while (bits == 0) {
+                    if (byte + 1 < sieve.segment_bytes()) byte++;
+                    else if (sieve.next_segment()) byte = 0;
+                    else {
+                        done = true;
+                        return;
+                    }
+                    bits = sieve.segment_data()[byte];
+                }
+                current = static_cast<T>((sieve.segment_first_byte() + byte) * 30 + Wheel30::RESIDUES[std::countr_zero(bits)]);
+                bits &= bits - 1;
+            }
+
+            SegmentedSieve sieve;
+            std::array<std::uint64_t, 3> small = {};
+            std::size_t small_count = 0, small_next = 0;
+            //the wheel byte being read within the current segment, and its primes not read yet; no segment is sieved before the first advance()
+            std::size_t byte = static_cast<std::size_t>(-1);
+            std::uint32_t bits = 0;
+            T current = T(0);
+            bool done = false;
+        };
+    }
+}
+
+#endif
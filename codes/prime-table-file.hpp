@@ -0,0 +1,152 @@
+#ifndef UMJCUTIL_MATH_PRIME_TABLE_FILE_HPP
+#define UMJCUTIL_MATH_PRIME_TABLE_FILE_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "isqrt.hpp"
+#include "sieve.hpp"
+#include "prime-counting.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief read-only, memory-mapped prime table file
+         * layout (version 1, native byte order, checked through a marker):
+         *   64-byte header | mod-30 wheel bitmap of [0, limit] padded to whole strides | one uint64 pi checkpoint per stride.
+         * opening is O(1) and every process mapping the same file shares its pages through the page cache.
+        */
+        class PrimeTableFile {
+        public:
+            static constexpr std::array<char, 8> MAGIC = { 'U', 'M', 'J', 'C', 'P', 'R', 'M', 'T' };
+            static constexpr std::uint32_t VERSION = 1;
+            static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+            //a checkpoint every 64 bytes (1920 integers) costs 1/8 of the bitmap and at most 8 popcounts per lookup
+            static constexpr std::uint64_t DEFAULT_STRIDE = 64;
+
+            struct Header {
+                std::array<char, 8> magic;
+                std::uint32_t version;
+                std::uint32_t byte_order;
+                std::uint64_t limit;
+                std::uint64_t stride; //bytes of bitmap per checkpoint
+                std::uint64_t bitmap_offset;
+                std::uint64_t bitmap_bytes;
+                std::uint64_t checkpoint_offset;
+                std::uint64_t checkpoint_count;
+            };
+            static_assert(sizeof(Header) == 64, "the header is part of the file format");
+
+            explicit PrimeTableFile(const std::string& path) {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) throw std::system_error(errno, std::generic_category(), "cannot open prime table " + path);
+                struct stat info;
+                if (::fstat(fd, &info) != 0) {
+                    int error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "cannot stat prime table " + path);
+                }
+                mapped_bytes = static_cast<std::size_t>(info.st_size);
+                void* address = mapped_bytes >= sizeof(Header) ? ::mmap(nullptr, mapped_bytes, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+                int error = errno;
+                ::close(fd);
+                if (mapped_bytes < sizeof(Header)) throw std::runtime_error("prime table " + path + " is truncated");
+                if (address == MAP_FAILED) throw std::system_error(error, std::generic_category(), "cannot map prime table " + path);
+                mapping = static_cast<const std::uint8_t*>(address);
+                try {
+                    validate(path);
+                }
+                catch (...) {
+                    ::munmap(const_cast<std::uint8_t*>(mapping), mapped_bytes);
+                    throw;
+                }
+                index = WheelIndex(mapping + header().bitmap_offset, reinterpret_cast<const std::uint64_t*>(mapping + header().checkpoint_offset), header().stride, header().limit);
+            }
+            PrimeTableFile(const PrimeTableFile&) = delete;
+            PrimeTableFile& operator=(const PrimeTableFile&) = delete;
+            ~PrimeTableFile() {
+                ::munmap(const_cast<std::uint8_t*>(mapping), mapped_bytes);
+            }
+
+            const Header& header() const { return *reinterpret_cast<const Header*>(mapping); }
+            std::uint64_t limit() const { return index.limit(); }
+            std::uint64_t pi(std::uint64_t v) const { return index.pi(v); }
+            bool is_prime(std::uint64_t v) const { return index.is_prime(v); }
+            template <typename Callback>
+            void for_each_prime(std::uint64_t low, std::uint64_t high, Callback&& callback) const {
+                index.for_each_prime(low, high, callback);
+            }
+
+            /**
+             * @brief writes the table of every prime up to limit to path
+             * sieves segment by segment and streams the bitmap out, so memory stays O(segment + sqrt(limit)) while the file is O(limit / 30).
+            */
+            static void write(const std::string& path, std::uint64_t limit, std::uint64_t stride = DEFAULT_STRIDE) {
+                if (stride == 0 || stride % 8 != 0) throw std::invalid_argument("the checkpoint stride must be a positive multiple of 8 bytes");
+                Header head = {};
+                head.magic = MAGIC;
+                head.version = VERSION;
+                head.byte_order = BYTE_ORDER_MARK;
+                head.limit = limit;
+                head.stride = stride;
+                head.bitmap_offset = sizeof(Header);
+                head.bitmap_bytes = (limit / 30 / stride + 1) * stride;
+                head.checkpoint_offset = head.bitmap_offset + head.bitmap_bytes;
+                head.checkpoint_count = head.bitmap_bytes / stride + 1;
+
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                if (!out) throw std::runtime_error("cannot create prime table " + path);
+                out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+                std::vector<std::uint64_t> checkpoints = { 0 };
+                checkpoints.reserve(static_cast<std::size_t>(head.checkpoint_count));
+                std::uint64_t running = 0, written = 0;
+                auto emit = [&](const std::uint8_t* bytes, std::size_t count) {
+                    out.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(count));
+                    for (std::size_t i = 0; i < count; i++) {
+                        running += std::popcount(bytes[i]);
+                        if (++written % stride == 0) checkpoints.push_back(running);
+                    }
+                };
+                std::vector<std::uint64_t> base = SegmentedSieve::primes_up_to(isqrt(limit));
+                SegmentedSieve sieve(0, limit, base.begin(), base.end());
+                while (sieve.next_segment()) emit(sieve.segment_data(), sieve.segment_bytes());
+                std::vector<std::uint8_t> padding(static_cast<std::size_t>(head.bitmap_bytes - written), 0);
+                emit(padding.data(), padding.size());
+                out.write(reinterpret_cast<const char*>(checkpoints.data()), static_cast<std::streamsize>(checkpoints.size() * sizeof(std::uint64_t)));
+                out.close();
+                if (!out) throw std::runtime_error("cannot write prime table " + path);
+            }
+
+        private:
+            void validate(const std::string& path) const {
+                const Header& head = header();
+                if (head.magic != MAGIC) throw std::runtime_error(path + " is not a prime table");
+                if (head.byte_order != BYTE_ORDER_MARK) throw std::runtime_error("prime table " + path + " was written with another byte order");
+                if (head.version != VERSION) throw std::runtime_error("prime table " + path + " has unsupported version " + std::to_string(head.version));
+                if (head.stride == 0 || head.stride % 8 != 0 || head.bitmap_offset % 8 != 0 || head.checkpoint_offset % 8 != 0
+                    || head.bitmap_bytes < head.limit / 30 + 1 || head.bitmap_bytes % head.stride != 0
+                    || head.checkpoint_count != head.bitmap_bytes / head.stride + 1
+                    || head.bitmap_offset + head.bitmap_bytes > head.checkpoint_offset
+                    || head.checkpoint_offset + head.checkpoint_count * sizeof(std::uint64_t) > mapped_bytes) {
+                    throw std::runtime_error("prime table " + path + " is corrupted or truncated");
+                }
+            }
+
+            const std::uint8_t* mapping = nullptr;
+            std::size_t mapped_bytes = 0;
+            WheelIndex index;
+        };
+    }
+}
+
+#endif
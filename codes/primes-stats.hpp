@@ -0,0 +1,207 @@
+#ifndef UMJCUTIL_MATH_PRIMES_STATS_HPP
+#define UMJCUTIL_MATH_PRIMES_STATS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+//build with -DUMJCUTIL_MATH_PRIMES_STATS=1 to have Primes<T> count how it answers every call.
+//without it the probes below are empty and compile to nothing, and Primes<T>::stats() only reports the cache.
+#ifndef UMJCUTIL_MATH_PRIMES_STATS
+#define UMJCUTIL_MATH_PRIMES_STATS 0
+#endif
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief snapshot of how Primes<T> has answered so far, from Primes<T>::stats()
+         * counters are exact; the latency histograms of is_prime() are sampled, one call in LATENCY_SAMPLE (at random) being timed,
+         * since reading the clock costs more than a seed table lookup. factor(), the batch calls and pi() are timed every time. bucket b counts calls that took [2^(b - 1), 2^b) ns, bucket 0 under 1 ns.
+        */
+        struct PrimesStats {
+            static constexpr bool ENABLED = UMJCUTIL_MATH_PRIMES_STATS != 0;
+            static constexpr std::size_t HISTOGRAM_BUCKETS = 40;
+            static constexpr std::uint32_t LATENCY_SAMPLE = 64;
+            using Histogram = std::array<std::uint64_t, HISTOGRAM_BUCKETS>;
+
+            //the way a call was answered
+            enum class Path {
+                is_prime_seed_table,     //at most SEED_LIMIT, from the compiled-in bitset
+                is_prime_table_file,     //from an attached table file
+                is_prime_trivial,        //nonpositive, or divisible by 2 or 5
+                is_prime_binary_search,  //below the cache limit
+                is_prime_trial_division, //by the cached primes up to TRIAL_DIVISION_ROOT_LIMIT
+                is_prime_miller_rabin,
+                is_prime_sieve,          //wider than 64 bits: trial division by the cached primes, then by primes up to isqrt(x) streamed from a segmented sieve without extending the cache
+                factor_trial_division,   //no cofactor left for rho
+                factor_pollard_rho,
+                batch,                   //one is_prime_batch() or count_primes_in() call
+                pi_table_file,
+                pi_cache,                //counted in the cache
+                pi_sieve,                //the rest of the range sieved on the ThreadPool
+                pi_meissel_lehmer,
+                count
+            };
+            static constexpr std::size_t PATH_COUNT = static_cast<std::size_t>(Path::count);
+
+            struct PathStats {
+                std::uint64_t calls = 0;
+                Histogram latency = {};
+            };
+            std::array<PathStats, PATH_COUNT> paths = {};
+
+            //cache extensions that did the sieving (or table decoding) themselves, and how long that took
+            std::uint64_t extensions = 0;
+            std::uint64_t extension_nanoseconds = 0;
+            Histogram extension_latency = {};
+            //extensions that found the writer lock taken, and the time spent waiting for it
+            std::uint64_t lock_waits = 0;
+            std::uint64_t lock_wait_nanoseconds = 0;
+
+            //filled in whether or not ENABLED
+            std::size_t cached_primes = 0;
+            std::uint64_t cache_limit = 0;
+            std::size_t cache_bytes = 0;
+
+            const PathStats& operator[](Path path) const {
+                return paths[static_cast<std::size_t>(path)];
+            }
+        };
+
+        namespace PrimesStatsDetail {
+            inline std::size_t bucket_of(std::uint64_t nanoseconds) {
+                return std::min<std::size_t>(std::bit_width(nanoseconds), PrimesStats::HISTOGRAM_BUCKETS - 1);
+            }
+            inline std::uint64_t nanoseconds_since(std::chrono::steady_clock::time_point start) {
+                return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            }
+
+#if UMJCUTIL_MATH_PRIMES_STATS
+            /**
+             * @brief per-thread call counts and latency histograms, plus shared counters for the rare cache extensions
+             * each thread counts into its own slot, a plain add with no locked instruction and no cache line shared with other threads;
+             * copy_to() sums the slots with relaxed loads. slots are never freed, so the calls of threads that have ended still count.
+            */
+            class Counters {
+            public:
+                void record(PrimesStats::Path path, bool timed, std::uint64_t nanoseconds) {
+                    Slot& slot = local_slot();
+                    std::size_t p = static_cast<std::size_t>(path);
+                    //only this thread writes the slot, so a relaxed load and store make an increment
+                    slot.calls[p].store(slot.calls[p].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    if (timed) {
+                        auto& bucket = slot.latency[p][bucket_of(nanoseconds)];
+                        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    }
+                }
+                void record_extension(std::uint64_t nanoseconds) {
+                    extensions.fetch_add(1, std::memory_order_relaxed);
+                    extension_nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+                    extension_latency[bucket_of(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+                }
+                void record_lock_wait(std::uint64_t nanoseconds) {
+                    lock_waits.fetch_add(1, std::memory_order_relaxed);
+                    lock_wait_nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+                }
+                void copy_to(PrimesStats& out) const {
+                    {
+                        std::lock_guard<std::mutex> slots_lock(slots_mutex);
+                        for (const auto& slot : slots) {
+                            for (std::size_t p = 0; p < PrimesStats::PATH_COUNT; p++) {
+                                out.paths[p].calls += slot->calls[p].load(std::memory_order_relaxed);
+                                for (std::size_t b = 0; b < PrimesStats::HISTOGRAM_BUCKETS; b++) out.paths[p].latency[b] += slot->latency[p][b].load(std::memory_order_relaxed);
+                            }
+                        }
+                    }
+                    out.extensions = extensions.load(std::memory_order_relaxed);
+                    out.extension_nanoseconds = extension_nanoseconds.load(std::memory_order_relaxed);
+                    for (std::size_t b = 0; b < PrimesStats::HISTOGRAM_BUCKETS; b++) out.extension_latency[b] = extension_latency[b].load(std::memory_order_relaxed);
+                    out.lock_waits = lock_waits.load(std::memory_order_relaxed);
+                    out.lock_wait_nanoseconds = lock_wait_nanoseconds.load(std::memory_order_relaxed);
+                }
+
+            private:
+                struct alignas(64) Slot {
+                    std::array<std::atomic<std::uint64_t>, PrimesStats::PATH_COUNT> calls = {};
+                    std::array<std::array<std::atomic<std::uint64_t>, PrimesStats::HISTOGRAM_BUCKETS>, PrimesStats::PATH_COUNT> latency = {};
+                };
+                //this thread's slot in this Counters; a thread rarely uses more than a few Primes<T>, so the lookup is a short scan
+                Slot& local_slot() {
+                    thread_local std::vector<std::pair<const Counters*, Slot*>> owned;
+                    for (const auto& entry : owned) {
+                        if (entry.first == this) return *entry.second;
+                    }
+                    std::lock_guard<std::mutex> slots_lock(slots_mutex);
+                    slots.push_back(std::make_unique<Slot>());
+                    owned.push_back({ this, slots.back().get() });
+                    return *slots.back();
+                }
+
+                mutable std::mutex slots_mutex;
+                std::vector<std::unique_ptr<Slot>> slots;
+                std::atomic<std::uint64_t> extensions = 0;
+                std::atomic<std::uint64_t> extension_nanoseconds = 0;
+                std::array<std::atomic<std::uint64_t>, PrimesStats::HISTOGRAM_BUCKETS> extension_latency = {};
+                std::atomic<std::uint64_t> lock_waits = 0;
+                std::atomic<std::uint64_t> lock_wait_nanoseconds = 0;
+            };
+
+            /**
+             * @brief counts one call under the last path given to at(), when it goes out of scope
+             * one probe in LATENCY_SAMPLE, picked at random, is timed as well.
+            */
+            class Probe {
+            public:
+                //always_timed: for calls that cost far more than reading the clock, which are also too rare to sample
+                Probe(Counters& counters, PrimesStats::Path path, bool always_timed = false) : counters(counters), path(path), timed(always_timed || next_random() % PrimesStats::LATENCY_SAMPLE == 0) {
+                    if (timed) start = std::chrono::steady_clock::now();
+                }
+                Probe(const Probe&) = delete;
+                Probe& operator=(const Probe&) = delete;
+                ~Probe() {
+                    counters.record(path, timed, timed ? nanoseconds_since(start) : 0);
+                }
+                void at(PrimesStats::Path taken) {
+                    path = taken;
+                }
+
+            private:
+                //xorshift32: a plain call counter would alias with loops that alternate between paths, such as even and odd candidates
+                static std::uint32_t next_random() {
+                    thread_local std::uint32_t state = 0x9E3779B9u;
+                    state ^= state << 13;
+                    state ^= state >> 17;
+                    state ^= state << 5;
+                    return state;
+                }
+                Counters& counters;
+                PrimesStats::Path path;
+                bool timed;
+                std::chrono::steady_clock::time_point start;
+            };
+#else
+            //nothing to count: every call below is empty and inlines away
+            struct Counters {
+                constexpr void record_extension(std::uint64_t) {}
+                constexpr void record_lock_wait(std::uint64_t) {}
+                constexpr void copy_to(PrimesStats&) const {}
+            };
+            class Probe {
+            public:
+                constexpr Probe(Counters&, PrimesStats::Path, bool = false) {}
+                constexpr void at(PrimesStats::Path) {}
+            };
+#endif
+        }
+    }
+}
+
+#endif
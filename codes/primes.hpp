@@ -2,14 +2,40 @@
 #define UMJCUTIL_MATH_PRIMES_HPP
 
 #include <vector>
-#include <mutex>
 #include <algorithm>
 #include <numeric>
-#include <thread>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include "isqrt.hpp"
+#include "constexpr-primes.hpp"
+#include "miller-rabin.hpp"
+#include "divisibility.hpp"
+#include "pollard-rho.hpp"
+#include "sieve.hpp"
+#include "prime-counting.hpp"
+#include "thread-pool.hpp"
+#include "prime-cache.hpp"
+#include "prime-range.hpp"
+#include "prime-table-file.hpp"
+#include "primes-stats.hpp"
 
 namespace UMJCUtil {
     namespace Math {
+        namespace PrimesDetail {
+            //the primes found so far, shared by every Primes<T>: one 4-byte copy of each prime in the process, however many types ask for it.
+            //isqrt of any value the sieve takes is below 2^32, so 32 bits are all the trial division and sieving base ever need.
+            using StoredPrime = std::uint32_t;
+            inline constexpr std::uint64_t STORE_LIMIT = std::numeric_limits<StoredPrime>::max();
+            inline PrimeCache<StoredPrime> store(SEED_PRIMES.begin(), SEED_PRIMES.end(), static_cast<StoredPrime>(SEED_LIMIT));
+        }
+
         /**
          * @brief thread-safe prime finding class
          * @tparam t: primitive integer type but 'bool'
@@ -20,34 +46,129 @@ namespace UMJCUtil {
         static_assert(std::numeric_limits<T>::is_integer, "this template was targeted for the integral types");
         static_assert(!std::is_same<T, bool>::value, "how do you find primes on the boolean ring?");
         private:
-            //to enhance prime finding algorithm, it collects the primes searched before that could possibly divide x.
-            static std::vector<T> prefound;
-            static T searched_limit;
-            static std::mutex mutex;
-            static void ensure_primes_up_to(T val) {
-                if (searched_limit < val) {
-                    std::lock_guard<std::mutex> mutex_lock(mutex);
-                    if (searched_limit % T(2) != T(0)) searched_limit++;
-                    for (T i = searched_limit + T(1); i <= val; i += 2) {
-                        bool i_is_prime = true;
-                        for (auto n : prefound) {
-                            if (i % n == 0) {
-                                i_is_prime = false;
-                                break;
-                            }
-                        }
-                        if (i_is_prime) {
-                            prefound.push_back(i);
-                        }
+            //to enhance prime finding algorithm, it collects the primes searched before that could possibly divide x, in PrimesDetail::store.
+            //readers take a snapshot without locking; extensions are serialized inside the store and published atomically.
+            using Snapshot = TypedSnapshot<T, PrimesDetail::StoredPrime>;
+            static Snapshot snapshot() {
+                return Snapshot(PrimesDetail::store.snapshot());
+            }
+            //memory-mapped table answering is_prime() and pi() up to its limit, nullptr until attach_table_file()
+            static std::atomic<const PrimeTableFile*> table_file;
+            //empty unless UMJCUTIL_MATH_PRIMES_STATS is set
+            static PrimesStatsDetail::Counters counters;
+            using Path = PrimesStats::Path;
+            static const PrimeTableFile* table_covering(T x) {
+                const PrimeTableFile* file = table_file.load(std::memory_order_acquire);
+                if (file == nullptr) return nullptr;
+                if constexpr (std::numeric_limits<T>::digits > 64) {
+                    if (x > T(std::numeric_limits<std::uint64_t>::max())) return nullptr;
+                }
+                return static_cast<std::uint64_t>(x) <= file->limit() ? file : nullptr;
+            }
+            //the store stops at STORE_LIMIT; primes above it are sieved where they are needed, see visit_primes_up_to()
+            static void ensure_primes_up_to(T val, std::size_t concurrency = 0) {
+                using PrimesDetail::StoredPrime;
+                StoredPrime bound = static_cast<StoredPrime>(std::min(to_sieve_bound(std::max(val, T(0))), PrimesDetail::STORE_LIMIT));
+                if (PrimesDetail::store.limit() >= bound) return;
+                //sieving (limit, bound] needs every prime up to isqrt(bound) first
+                StoredPrime root = isqrt(bound);
+                if (PrimesDetail::store.limit() < root) ensure_primes_up_to(static_cast<T>(root), concurrency);
+                auto producer = [bound, concurrency](const typename PrimeCache<StoredPrime>::Snapshot& base, typename PrimeCache<StoredPrime>::Appender& out) {
+                    //a table file covering the range only needs decoding, not sieving
+                    if (const PrimeTableFile* file = table_covering(static_cast<T>(bound))) {
+                        file->for_each_prime(std::uint64_t(base.limit()) + 1, bound, [&out](std::uint64_t p) { out.push_back(static_cast<StoredPrime>(p)); });
+                        return;
+                    }
+                    SegmentedSieve::collect_parallel(std::uint64_t(base.limit()) + 1, bound, base.begin(), base.end(), out, concurrency);
+                };
+                if constexpr (PrimesStats::ENABLED) {
+                    std::uint64_t waited = 0;
+                    auto start = std::chrono::steady_clock::now();
+                    bool extended = PrimesDetail::store.extend(bound, producer, &waited);
+                    if (waited != 0) counters.record_lock_wait(waited);
+                    if (extended) counters.record_extension(PrimesStatsDetail::nanoseconds_since(start) - waited);
+                }
+                else PrimesDetail::store.extend(bound, producer);
+            }
+            //calls visit(p) for every prime p <= bound in ascending order until it returns false: the stored ones, then the rest
+            //streamed from a segmented sieve without being stored. only values wider than 64 bits get past the store.
+            template <typename Visit>
+            static void visit_primes_up_to(T bound, Visit&& visit) {
+                auto primes = snapshot();
+                for (auto it = primes.begin(); it != primes.end() && *it <= bound; ++it) {
+                    if (!visit(*it)) return;
+                }
+                if (bound <= primes.limit()) return;
+                for (T p : primes_between(primes.limit() + T(1), bound)) {
+                    if (!visit(p)) return;
+                }
+            }
+            //candidates go through the small factor filter this many at a time, which is also the unit of parallel work
+            static constexpr std::size_t BATCH_CHUNK = 2048;
+            //calls verdict(i, is_prime(values[i])) for every i < count
+            template <typename Verdict>
+            static void classify(const T* values, std::size_t count, Verdict&& verdict) {
+                std::array<std::uint64_t, BATCH_CHUNK> wide;
+                std::array<std::uint32_t, BATCH_CHUNK> narrow;
+                std::array<bool, BATCH_CHUNK> has_factor;
+                for (std::size_t begin = 0; begin < count; begin += BATCH_CHUNK) {
+                    std::size_t size = std::min(BATCH_CHUNK, count - begin);
+                    std::uint64_t largest = 0;
+                    for (std::size_t i = 0; i < size; i++) {
+                        //nonpositive and wider-than-64-bit values get lane 0, which is flagged as even, and are decided below
+                        T x = values[begin + i];
+                        bool in_lane = x > T(0) && (std::numeric_limits<T>::digits <= 64 || x <= T(std::numeric_limits<std::uint64_t>::max()));
+                        wide[i] = in_lane ? static_cast<std::uint64_t>(x) : 0;
+                        largest = std::max(largest, wide[i]);
+                    }
+                    //32-bit lanes are twice as many per vector
+                    if (largest >> 32 == 0) {
+                        std::copy(wide.begin(), wide.begin() + size, narrow.begin());
+                        SmallFactorFilter::mark(narrow.data(), size, has_factor.data());
+                    }
+                    else SmallFactorFilter::mark(wide.data(), size, has_factor.data());
+                    const PrimeTableFile* file = table_covering(static_cast<T>(largest));
+                    for (std::size_t i = 0; i < size; i++) {
+                        std::uint64_t n = wide[i];
+                        bool rtrn;
+                        if (n == 0) rtrn = values[begin + i] > T(0) && is_prime(values[begin + i]);
+                        else if (n <= SEED_LIMIT) rtrn = sieve_bitset_test<SEED_LIMIT>(SEED_BITSET, n);
+                        else if (has_factor[i]) rtrn = false;
+                        else if (n < SmallFactorFilter::PRIME_BELOW) rtrn = true;
+                        else if (file != nullptr) rtrn = file->is_prime(n);
+                        else rtrn = MillerRabin::is_prime(n);
+                        verdict(begin + i, rtrn);
                     }
-                    searched_limit = val;
                 }
             }
+            static std::uint64_t to_sieve_bound(T val) {
+                if constexpr (std::numeric_limits<T>::digits > 64) {
+                    if (val > static_cast<T>(SegmentedSieve::MAX_HIGH)) throw std::domain_error("the value exceeds the range of the prime sieve");
+                }
+                return static_cast<std::uint64_t>(val);
+            }
         public:
+            //above this, pi() switches from sieving the whole range to Meissel-Lehmer
+            static constexpr std::uint64_t MEISSEL_LEHMER_THRESHOLD = 10'000'000;
+            //is_prime() trial-divides by cached primes only while isqrt(x) is at most this (about 50 divisions), Miller-Rabin above.
+            static constexpr std::uint64_t TRIAL_DIVISION_ROOT_LIMIT = 256;
+            //factor() trial-divides by the cached primes up to this before handing the cofactor to Pollard-Brent rho.
+            static constexpr std::uint64_t FACTOR_TRIAL_LIMIT = 1024;
+
             static bool is_prime(T x) {
+                PrimesStatsDetail::Probe probe(counters, Path::is_prime_trivial);
                 if (x <= T(0)) {
                     return false; //negative prime is not a thing.
                 }
+                //small values are looked up in the table compiled into the binary; values wider than 64 bits must not be cut down to their low bits first
+                if ((std::numeric_limits<T>::digits <= 64 || x <= T(std::numeric_limits<std::uint64_t>::max())) && static_cast<std::uint64_t>(x) <= SEED_LIMIT) {
+                    probe.at(Path::is_prime_seed_table);
+                    return sieve_bitset_test<SEED_LIMIT>(SEED_BITSET, static_cast<std::size_t>(x));
+                }
+                if (const PrimeTableFile* file = table_covering(x)) {
+                    probe.at(Path::is_prime_table_file);
+                    return file->is_prime(static_cast<std::uint64_t>(x));
+                }
                 if (x == T(1)) {
                     return false;
                 }
@@ -69,109 +190,221 @@ namespace UMJCUtil {
                 if (x % T(5) == 0) {
                     return false;
                 }
+                auto primes = snapshot();
                 //만일 x가 작아 이미 찾은 최대 소수보다도 작다면 이진 탐색 사용
-                if (x <= searched_limit) {
-                    return std::binary_search(prefound.begin(), prefound.end(), x);
+                if (x <= primes.limit()) {
+                    probe.at(Path::is_prime_binary_search);
+                    return std::binary_search(primes.begin(), primes.end(), x);
                 }
                 T root = isqrt(x);
-                //x의 제곱근이 현재 기억하고 있는 최대 소수보다 작다면, 바로 나눗셈 가능 여부 확인
-                if (root <= searched_limit) {
-                    return std::all_of(prefound.begin(), prefound.end(), [x](T found_prime){return x % found_prime != 0;});
+                //나눗셈 몇 번으로 끝나는 크기라면 이미 찾은 소수로 나눠 보는 편이 Miller-Rabin보다 빠르다
+                if (root <= primes.limit() && root <= T(TRIAL_DIVISION_ROOT_LIMIT)) {
+                    probe.at(Path::is_prime_trial_division);
+                    return std::all_of(primes.begin(), primes.upper_bound(root), [x](T found_prime){return x % found_prime != 0;});
                 }
-                ensure_primes_up_to(root);
-                return std::all_of(prefound.begin(), prefound.end(), [x](T found_prime){return x % found_prime != 0;});
+                //64비트에 들어가는 수는 소수를 더 찾지 않고 결정적 Miller-Rabin으로 판정한다
+                if (std::numeric_limits<T>::digits <= 64 || x <= T(std::numeric_limits<std::uint64_t>::max())) {
+                    probe.at(Path::is_prime_miller_rabin);
+                    return MillerRabin::is_prime(static_cast<std::uint64_t>(x));
+                }
+                probe.at(Path::is_prime_sieve);
+                //기억하고 있는 소수로 나눠 본 뒤, x의 제곱근까지 남은 소수는 캐시에 넣지 않고 구간 체로 흘려 가며 나눠 본다
+                bool rtrn = true;
+                visit_primes_up_to(root, [x, &rtrn](T found_prime) { return rtrn = x % found_prime != 0; });
+                return rtrn;
             }
         
+            /**
+             * @brief prime factorization as (prime, exponent) pairs in ascending order of the primes; 1 has none.
+             * divides out the cached primes up to FACTOR_TRIAL_LIMIT, then splits what is left with Pollard-Brent rho, Miller-Rabin telling when to stop.
+             * values wider than 64 bits fall back to trial division by every prime up to isqrt(x).
+            */
             static std::vector<std::pair<T, int>> factor(T x) {
                 if (x <= T(0)) throw std::domain_error("nonpositive numbers cannot be factored");
-                if (x == T(1)) return { 1 };
-                if (is_prime(x)) return {1, x};
-                ensure_primes_up_to(isqrt(x));
-                std::vector<T> rtrn = {};
-                for (std::size_t i = 0; i < prefound.size(); ) {
-                    if (x % prefound[i] == 0) {
-                        if (rtrn.empty() || rtrn.back().first != prefound[i]) rtrn.push_back({prefound[i], 1});
-                        else if (rtrn.back().first == prefound[i]) rtrn.back().second++;
-                        x /= prefound[i];
-                        if (x == T(1)) break;
-                    }
-                    else {
-                        i++;
+                PrimesStatsDetail::Probe probe(counters, Path::factor_trial_division, true);
+                std::vector<std::pair<T, int>> rtrn = {};
+                auto push = [&rtrn](T p) {
+                    if (rtrn.empty() || rtrn.back().first != p) rtrn.push_back({ p, 1 });
+                    else rtrn.back().second++;
+                };
+                bool wide = std::numeric_limits<T>::digits > 64 && x > T(std::numeric_limits<std::uint64_t>::max());
+                T trial_limit = wide ? isqrt(x) : static_cast<T>(std::min<std::uint64_t>(FACTOR_TRIAL_LIMIT, std::numeric_limits<T>::max()));
+                if (!wide) ensure_primes_up_to(trial_limit);
+                visit_primes_up_to(trial_limit, [&x, &push](T p) {
+                    if (p > x / p) return false;
+                    while (x % p == T(0)) {
+                        push(p);
+                        x /= p;
                     }
+                    return true;
+                });
+                if (x == T(1)) return rtrn;
+                //x에 trial_limit 이하의 소인수가 없으므로 x < (trial_limit + 1)^2이면 x는 소수이다
+                if (isqrt(x) <= trial_limit) {
+                    push(x);
+                    return rtrn;
                 }
+                probe.at(Path::factor_pollard_rho);
+                std::vector<std::uint64_t> factors = {};
+                PollardRho::factor_into(static_cast<std::uint64_t>(x), factors);
+                std::sort(factors.begin(), factors.end());
+                for (auto p : factors) push(static_cast<T>(p));
                 return rtrn;
             }
 
-            static std::size_t pi(T n) {
+            /**
+             * @brief rtrn[i] = is_prime(values[i]) for every i
+             * candidates are screened in bulk by SmallFactorFilter, whose vector kernels test several of them per instruction against every prime below 2^9;
+             * the few that survive go to Miller-Rabin (or to an attached table file) one by one.
+             * @param concurrency: at most this many threads of the shared ThreadPool work on the call, 0 for the pool's setting
+            */
+            static void is_prime_batch(std::span<const T> values, std::span<bool> rtrn, std::size_t concurrency = 0) {
+                if (rtrn.size() != values.size()) throw std::invalid_argument("is_prime_batch needs one output per value");
+                PrimesStatsDetail::Probe probe(counters, Path::batch, true);
+                std::size_t chunks = (values.size() + BATCH_CHUNK - 1) / BATCH_CHUNK;
+                ThreadPool::shared().parallel_for(chunks, [&](std::size_t chunk) {
+                    std::size_t begin = chunk * BATCH_CHUNK;
+                    bool* out = rtrn.data() + begin;
+                    classify(values.data() + begin, std::min(BATCH_CHUNK, values.size() - begin), [out](std::size_t i, bool prime) { out[i] = prime; });
+                }, concurrency);
+            }
+            //how many of values are prime, duplicates counted every time; see is_prime_batch()
+            static std::size_t count_primes_in(std::span<const T> values, std::size_t concurrency = 0) {
+                PrimesStatsDetail::Probe probe(counters, Path::batch, true);
+                std::size_t chunks = (values.size() + BATCH_CHUNK - 1) / BATCH_CHUNK;
+                std::atomic<std::size_t> rtrn = 0;
+                ThreadPool::shared().parallel_for(chunks, [&](std::size_t chunk) {
+                    std::size_t begin = chunk * BATCH_CHUNK, found = 0;
+                    classify(values.data() + begin, std::min(BATCH_CHUNK, values.size() - begin), [&found](std::size_t, bool prime) { found += prime; });
+                    rtrn += found;
+                }, concurrency);
+                return rtrn.load();
+            }
+
+            //concurrency: at most this many threads of the shared ThreadPool work on the call, 0 for the pool's setting
+            static std::size_t pi(T n, std::size_t concurrency = 0) {
                 if (n <= T(1)) {
                     return 0;
                 }
-                if (n <= searched_limit) {
-                    return static_cast<std::size_t>(std::distance(prefound.begin(), std::upper_bound(prefound.begin(), prefound.end(), n)));
+                PrimesStatsDetail::Probe probe(counters, Path::pi_table_file, true);
+                if (const PrimeTableFile* file = table_covering(n)) {
+                    return static_cast<std::size_t>(file->pi(static_cast<std::uint64_t>(n)));
+                }
+                auto primes = snapshot();
+                if (n <= primes.limit()) {
+                    probe.at(Path::pi_cache);
+                    return static_cast<std::size_t>(primes.upper_bound(n) - primes.begin());
                 }
                 else {
                     //ensure primes under floor(isqrt(n))
                     T root = isqrt(n);
+                    ensure_primes_up_to(root, concurrency);
+                    primes = snapshot();
+                    if (to_sieve_bound(n) >= MEISSEL_LEHMER_THRESHOLD) {
+                        probe.at(Path::pi_meissel_lehmer);
+                        return static_cast<std::size_t>(MeisselLehmer::pi(to_sieve_bound(n), primes.begin(), primes.upper_bound(root), concurrency));
+                    }
+                    probe.at(Path::pi_sieve);
+                    //나머지 구간은 저장하지 않고 체로 세기만 한다. 구간은 세그먼트 몇 개 단위로 잘라 스레드 풀에 나눠 준다.
+                    return static_cast<std::size_t>(SegmentedSieve::count_parallel(to_sieve_bound(primes.limit()) + 1, to_sieve_bound(n), primes.begin(), primes.end(), concurrency)) + primes.size();
+                }
+            }
+            
+            /**
+             * @brief answers is_prime() and pi() up to the limit of a prime table file, and fills the cache from it instead of sieving
+             * the file is mapped read-only, so attaching is O(1) and its pages are shared with every other process mapping it.
+             * the last table attached wins; earlier ones stay mapped since readers may still be using them.
+            */
+            static void attach_table_file(std::shared_ptr<const PrimeTableFile> file) {
+                static std::mutex owners_mutex;
+                static std::vector<std::shared_ptr<const PrimeTableFile>> owners;
+                std::lock_guard<std::mutex> owners_lock(owners_mutex);
+                owners.push_back(file);
+                table_file.store(file.get(), std::memory_order_release);
+            }
+            static void attach_table_file(const std::string& path) {
+                attach_table_file(std::make_shared<const PrimeTableFile>(path));
+            }
+
+            /**
+             * @brief the primes of [a, b] in ascending order, sieved one segment at a time as the range is read
+             * only the primes up to isqrt(b) are cached (or taken from an attached table file), so listing from an offset
+             * such as 10^15 takes time in proportion to b - a + sqrt(b), not to b.
+            */
+            static PrimeRange<T> primes_between(T a, T b) {
+                if (b < T(2) || a > b) return PrimeRange<T>(1, 0, SEED_PRIMES.begin(), SEED_PRIMES.begin());
+                std::uint64_t low = a < T(0) ? 0 : to_sieve_bound(a), high = to_sieve_bound(b);
+                T root = isqrt(b);
+                ensure_primes_up_to(root);
+                auto primes = snapshot();
+                return PrimeRange<T>(low, high, primes.begin(), primes.upper_bound(root));
+            }
+
+            /**
+             * @brief the nth prime, nth_prime(1) = 2
+             * pi() of an estimate of p_n (Meissel-Lehmer for large ones), then a local sieve from the estimate to p_n.
+             * the estimate is within about n / ln(n)^2 of p_n, so the sieving is small beside the pi() call.
+            */
+            static T nth_prime(std::uint64_t n) {
+                if (n == 0) throw std::domain_error("primes are counted from nth_prime(1) = 2");
+                {
+                    auto primes = snapshot();
+                    if (n <= primes.size()) return primes[static_cast<std::size_t>(n - 1)];
+                }
+                const std::uint64_t type_max = std::min<std::uint64_t>(SegmentedSieve::MAX_HIGH, std::numeric_limits<T>::digits >= 64 ? std::numeric_limits<std::uint64_t>::max() : static_cast<std::uint64_t>(std::numeric_limits<T>::max()));
+                //p_n ~ n (ln n + ln ln n - 1 + (ln ln n - 2) / ln n) (Cipolla)
+                double log_n = std::log(static_cast<double>(n)), log_log_n = std::log(log_n);
+                double estimate = static_cast<double>(n) * (log_n + log_log_n - 1.0 + (log_log_n - 2.0) / log_n);
+                std::uint64_t x = estimate < static_cast<double>(type_max) ? static_cast<std::uint64_t>(estimate) : type_max;
+                std::uint64_t counted = pi(static_cast<T>(x));
+                //p_n is in a window of a few sieve segments next to x: below when pi(x) >= n, above otherwise
+                const std::uint64_t window = std::uint64_t(SegmentedSieve::segment_bytes_for(x)) * 30 * 4;
+                while (true) {
+                    bool below = counted >= n;
+                    if (!below && x == type_max) throw std::domain_error("the nth prime is out of the range of the type");
+                    std::uint64_t low = below ? (x >= window ? x - window + 1 : 0) : x + 1;
+                    std::uint64_t high = below ? x : (type_max - low >= window ? low + window - 1 : type_max);
+                    T root = isqrt(static_cast<T>(high));
                     ensure_primes_up_to(root);
-                    std::vector<std::size_t> additional_founds = {};
-                    //계산해야 하는 양이 클 경우 스레드 사용
-                    T thread_count;
-                    T loop_count = (n - searched_limit) / 2;
-                    //10,000개 아래로는 스레드 1개
-                    if (loop_count < T(10'000)) thread_count = 1;
-                    //100,000개 아래로는 스레드 4개
-                    else if (loop_count < T(100'000)) thread_count = 4;
-                    //1,000,000개 아래로는 스레드 16개
-                    else if (loop_count < T(1'000'000)) thread_count = 16;
-                    //10,000,000개 아래로는 스레드 64개
-                    else if (loop_count < T(10'00'000)) thread_count = 64;
-                    //그 이상으로는 스레드 256개
-                    else thread_count = 256;
-                    additional_founds.resize(thread_count, 0);
-                    if ((n - searched_limit) % thread_count != 0) additional_founds.push_back(0);
-                    auto thread_func = [](T begin, T end, std::size_t* rtrn) {
-                        begin = begin % 2 == 0 ? begin + 1 : begin;
-                        for (T i = begin; i <= end; i += 2) {
-                            T root = isqrt(i);
-                            bool i_is_prime = true;
-                            for (auto k : prefound) {
-                                if (k > root) break;
-                                if (i % k == 0) {
-                                    i_is_prime = false;
-                                    break;
-                                }
-                            }
-                            if (i_is_prime) (*rtrn)++;
+                    auto primes = snapshot();
+                    std::uint64_t inside = SegmentedSieve(low, high, primes.begin(), primes.upper_bound(root)).count();
+                    //the primes up to low - 1 number counted - inside when below, counted otherwise
+                    std::uint64_t before = below ? counted - inside : counted;
+                    if (before < n && n <= before + inside) {
+                        std::uint64_t rank = n - before;
+                        for (T p : PrimeRange<T>(low, high, primes.begin(), primes.upper_bound(root))) {
+                            if (--rank == 0) return p;
                         }
-                    };
-                    std::vector<std::thread> thread_pool;
-                    for (T i = 0; i < thread_count; i++) {
-                        thread_pool.push_back(std::move(std::thread(
-                            thread_func, searched_limit + i * ((n - searched_limit) / thread_count) + 1, searched_limit + (i + 1) * ((n - searched_limit) / thread_count), &additional_founds[i]
-                        )));
                     }
-                    if ((n - searched_limit) % thread_count != 0) {
-                        thread_pool.push_back(std::move(std::thread(
-                            thread_func, searched_limit + thread_count * ((n - searched_limit) / thread_count) + 1, n, &additional_founds[thread_count]
-                        )));
-                    }
-                    for (auto& th : thread_pool) {
-                        th.join();
-                    }
-                    return std::accumulate(additional_founds.begin(), additional_founds.end(), std::size_t(0)) + prefound.size();
+                    counted = below ? before : before + inside;
+                    x = below ? low - 1 : high;
                 }
             }
-            
-            static const std::vector<T>& get_prefounds() {
-                return prefound;
+
+            /**
+             * @brief the size of the prime store, and with UMJCUTIL_MATH_PRIMES_STATS set, how every call has been answered so far
+             * the store is shared by every Primes<T>, so its figures are the same for all of them; the call counters are this T's own.
+             * the counters are read one by one with relaxed loads, so a snapshot taken while other threads run may be off by their calls in flight.
+            */
+            static PrimesStats stats() {
+                PrimesStats rtrn;
+                counters.copy_to(rtrn);
+                auto primes = PrimesDetail::store.snapshot();
+                rtrn.cached_primes = primes.size();
+                rtrn.cache_limit = static_cast<std::uint64_t>(primes.limit());
+                rtrn.cache_bytes = PrimesDetail::store.allocated_bytes();
+                return rtrn;
+            }
+
+            //every prime found so far up to the largest T, as an immutable snapshot that later extensions leave untouched
+            static Snapshot get_prefounds() {
+                return snapshot();
             }
         };
         template <typename T>
-        std::vector<T> Primes<T>::prefound = { T(2), T(3), T(5), T(7) };
-        template <typename T>
-        T Primes<T>::searched_limit = T(7);
+        std::atomic<const PrimeTableFile*> Primes<T>::table_file(nullptr);
         template <typename T>
-        std::mutex Primes<T>::mutex;
+        PrimesStatsDetail::Counters Primes<T>::counters;
 
         //constexpr version of is_prime so you can ensure prime numbers for template parameters.
         //to do more efficient prime verification on runtime, consider using primes<t>::is_prime().
@@ -204,6 +437,9 @@ namespace UMJCUtil {
             if (number % T(5) == 0) {
                 return false;
             }
+            if ((std::numeric_limits<T>::digits <= 64 || number <= T(std::numeric_limits<std::uint64_t>::max())) && static_cast<std::uint64_t>(number) <= SEED_LIMIT) {
+                return sieve_bitset_test<SEED_LIMIT>(SEED_BITSET, static_cast<std::size_t>(number));
+            }
             //constexpr 함수이기 때문에 소수를 따로 저장하지 못하므로 isqrt(n) 이하의 모든 자연수에 대해서 확인한다.
             T loop_length = isqrt(number);
             for (T i = 3; i <= loop_length; i += 2) {
@@ -211,6 +447,10 @@ namespace UMJCUtil {
             }
             return true;
         }
+#ifdef __SIZEOF_INT128__
+        //3 (2^64 + 1) is 3 in its low 64 bits, which the seed table calls prime
+        static_assert(!is_prime((__int128(3) << 64) + 3) && !is_prime((static_cast<unsigned __int128>(3) << 64) + 3), "values wider than 64 bits are not looked up by their low bits");
+#endif
     }
 }
 
@@ -0,0 +1,335 @@
+#ifndef UMJCUTIL_MATH_QUANTILE_SOLVER_HPP
+#define UMJCUTIL_MATH_QUANTILE_SOLVER_HPP
+
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/math/distributions/chi_squared.hpp>
+#include <boost/math/distributions/fisher_f.hpp>
+#include <boost/math/distributions/normal.hpp>
+#include <boost/math/distributions/students_t.hpp>
+
+namespace UMJCUtil {
+    namespace Math {
+        /**
+         * @brief upper quantiles of the chi-squared, t and F distributions for table generation
+         * every inversion runs Halley's method on the log of the tail probability against log x, which is close to linear in both the power-law
+         * and the exponential tails. the start is an asymptotic expansion (Wilson-Hilferty, Cornish-Fisher, Paulson), or the power-law tail
+         * where the degrees of freedom are too few for those, corrected by the expansion's error at the solved cells before it when the caller has them.
+         * from there one step usually lands within 10^-5, and the next one, cubically convergent, is the last: two cdf/pdf evaluations a cell,
+         * fewer than boost::math::quantile takes.
+         * results are memoized by (distribution, parameters, alpha, tolerance), in a file too if a path is given, so rebuilding a table costs lookups only.
+         * thread-safe.
+        */
+        class QuantileSolver {
+        public:
+            enum class Distribution : int { chi_squared = 0, students_t = 1, fisher_f = 2 };
+            struct Statistics {
+                std::size_t queries = 0;
+                std::size_t cache_hits = 0;
+                std::size_t solves = 0;
+                std::size_t iterations = 0; //Halley steps, one cdf and one pdf each
+                std::size_t fallbacks = 0; //solves that did not converge and went to boost::math::quantile
+            };
+            //relative error of x; far below what a 5-digit table shows
+            static constexpr double DEFAULT_TOLERANCE = 1e-13;
+            static constexpr int MAX_ITERATIONS = 64;
+
+            //cache_path: empty for a cache that lives in memory only
+            explicit QuantileSolver(std::string cache_path = "", double tolerance = DEFAULT_TOLERANCE) : cache_path(std::move(cache_path)), tolerance(tolerance) {
+                if (!this->cache_path.empty()) load();
+            }
+            QuantileSolver(const QuantileSolver&) = delete;
+            QuantileSolver& operator=(const QuantileSolver&) = delete;
+            ~QuantileSolver() {
+                try {
+                    save();
+                }
+                catch (...) {
+                    //a cache that cannot be written only costs the next run its speed
+                }
+            }
+
+            /**
+             * @brief x with P(X > x) = alpha
+             * @param nu2: the denominator degrees of freedom of F, ignored otherwise
+             * @param preceding: solved quantiles at the same alpha for the last degrees of freedom minus preceding.size(), ..., minus 1
+             *   (nu2 of F, nu1 otherwise), as a table column walked downwards has them; empty for the asymptotic start alone
+            */
+            double upper(Distribution distribution, double nu1, double nu2, double alpha, std::span<const double> preceding = {}) {
+                if (!(alpha > 0.0 && alpha < 1.0)) throw std::domain_error("alpha must be in (0, 1)");
+                if (distribution != Distribution::fisher_f) nu2 = 0.0;
+                Key key = { distribution, nu1, nu2, alpha, tolerance };
+                queries++;
+                {
+                    std::lock_guard<std::mutex> cache_lock(cache_mutex);
+                    auto found = cache.find(key);
+                    if (found != cache.end()) {
+                        cache_hits++;
+                        return found->second;
+                    }
+                }
+                double rtrn = solve(key, preceding);
+                std::lock_guard<std::mutex> cache_lock(cache_mutex);
+                cache.emplace(key, rtrn);
+                dirty = true;
+                return rtrn;
+            }
+            double chi_squared(double df, double alpha, std::span<const double> preceding = {}) {
+                return upper(Distribution::chi_squared, df, 0.0, alpha, preceding);
+            }
+            double students_t(double df, double alpha, std::span<const double> preceding = {}) {
+                return upper(Distribution::students_t, df, 0.0, alpha, preceding);
+            }
+            //preceding: the quantiles at (df1, df2 - k)
+            double fisher_f(double df1, double df2, double alpha, std::span<const double> preceding = {}) {
+                return upper(Distribution::fisher_f, df1, df2, alpha, preceding);
+            }
+
+            Statistics statistics() const {
+                Statistics rtrn;
+                rtrn.queries = queries.load();
+                rtrn.cache_hits = cache_hits.load();
+                rtrn.solves = solves.load();
+                rtrn.iterations = iterations.load();
+                rtrn.fallbacks = fallbacks.load();
+                return rtrn;
+            }
+
+            //writes the cache file if anything was solved since it was loaded; the destructor does this too
+            void save() {
+                std::lock_guard<std::mutex> cache_lock(cache_mutex);
+                if (cache_path.empty() || !dirty) return;
+                std::string temporary = cache_path + ".tmp";
+                {
+                    std::ofstream out(temporary, std::ios::trunc);
+                    if (!out) throw std::runtime_error("cannot create quantile cache " + temporary);
+                    out << CACHE_HEADER << "\n";
+                    for (const auto& [key, value] : cache) {
+                        out << static_cast<int>(key.distribution) << " " << hex(key.nu1) << " " << hex(key.nu2) << " " << hex(key.alpha) << " " << hex(key.tolerance) << " " << hex(value) << "\n";
+                    }
+                    out.close();
+                    if (!out) throw std::runtime_error("cannot write quantile cache " + temporary);
+                }
+                //readers of the file see the old or the new cache, never half of one
+                if (std::rename(temporary.c_str(), cache_path.c_str()) != 0) throw std::runtime_error("cannot replace quantile cache " + cache_path);
+                dirty = false;
+            }
+
+        private:
+            //version 2 keyed the values by bits of precision where version 3 keys them by tolerance
+            static constexpr const char* CACHE_HEADER = "UMJCQNTL 3";
+
+            struct Key {
+                Distribution distribution;
+                double nu1, nu2, alpha, tolerance;
+                bool operator==(const Key&) const = default;
+            };
+            struct KeyHash {
+                std::size_t operator()(const Key& key) const {
+                    std::size_t rtrn = static_cast<std::size_t>(key.distribution);
+                    for (double part : { key.nu1, key.nu2, key.alpha, key.tolerance }) rtrn = rtrn * 0x9E3779B97F4A7C15ull + std::hash<double>()(part);
+                    return rtrn;
+                }
+            };
+
+            //doubles are stored in hexadecimal so they read back bit for bit
+            static std::string hex(double x) {
+                char text[32];
+                return std::string(text, std::to_chars(text, text + sizeof(text), x, std::chars_format::hex).ptr);
+            }
+            static bool parse_hex(const std::string& text, double& x) {
+                auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), x, std::chars_format::hex);
+                return error == std::errc() && end == text.data() + text.size();
+            }
+
+            //a missing, foreign or damaged cache file is the same as an empty one
+            void load() {
+                std::ifstream in(cache_path);
+                std::string line;
+                if (!in || !std::getline(in, line) || line != CACHE_HEADER) return;
+                int distribution;
+                std::string nu1, nu2, alpha, tol, value;
+                while (in >> distribution >> nu1 >> nu2 >> alpha >> tol >> value) {
+                    Key key = { static_cast<Distribution>(distribution), 0.0, 0.0, 0.0, 0.0 };
+                    double x;
+                    if (distribution < 0 || distribution > 2 || !parse_hex(nu1, key.nu1) || !parse_hex(nu2, key.nu2) || !parse_hex(alpha, key.alpha) || !parse_hex(tol, key.tolerance) || !parse_hex(value, x)) {
+                        cache.clear();
+                        return;
+                    }
+                    cache.emplace(key, x);
+                }
+            }
+
+            //z with P(Z > z) = alpha
+            static double normal_upper(double alpha) {
+                return boost::math::quantile(boost::math::complement(boost::math::normal(), alpha));
+            }
+            //Wilson-Hilferty: (X / k)^(1/3) is nearly normal with mean 1 - 2 / 9k and variance 2 / 9k
+            static double chi_squared_seed(double k, double alpha) {
+                double v = 2.0 / (9.0 * k);
+                double cube = 1.0 - v + normal_upper(alpha) * std::sqrt(v);
+                if (cube > 0.2) return k * cube * cube * cube;
+                //the far lower tail, where P(X < x) ~ (x / 2)^(k / 2) / Gamma(k / 2 + 1)
+                return 2.0 * std::pow((1.0 - alpha) * std::tgamma(k / 2.0 + 1.0), 2.0 / k);
+            }
+            //Cornish-Fisher expansion of t in the normal quantile z and 1 / nu (Abramowitz and Stegun 26.7.5)
+            static double students_t_seed(double nu, double alpha) {
+                //few degrees of freedom leave a power-law tail, P(T > t) ~ Gamma((nu + 1) / 2) nu^((nu - 1) / 2) / (sqrt(pi) Gamma(nu / 2)) t^-nu
+                if (nu <= SMALL_DF) {
+                    double log_scale = std::lgamma((nu + 1.0) / 2.0) - std::lgamma(nu / 2.0) + (nu - 1.0) / 2.0 * std::log(nu) - std::log(std::numbers::pi) / 2.0;
+                    return std::exp((log_scale - std::log(alpha)) / nu);
+                }
+                double z = normal_upper(alpha), z2 = z * z;
+                double g1 = (z2 + 1.0) * z / 4.0;
+                double g2 = ((5.0 * z2 + 16.0) * z2 + 3.0) * z / 96.0;
+                double g3 = (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) * z / 384.0;
+                double g4 = ((((79.0 * z2 + 776.0) * z2 + 1482.0) * z2 - 1920.0) * z2 - 945.0) * z / 92160.0;
+                return z + (g1 + (g2 + (g3 + g4 / nu) / nu) / nu) / nu;
+            }
+            //Paulson: (1 - b) F^(1/3) - (1 - a) over sqrt(b F^(2/3) + a) is nearly normal, with a = 2 / 9 d1 and b = 2 / 9 d2
+            static double fisher_f_seed(double d1, double d2, double alpha) {
+                //few denominator degrees of freedom leave a power-law tail, P(F > x) ~ Gamma((d1 + d2) / 2) / (Gamma(d1 / 2) Gamma(d2 / 2 + 1)) (d2 / d1 x)^(d2 / 2)
+                if (d2 <= SMALL_DF && alpha <= 0.5) {
+                    double log_scale = std::lgamma((d1 + d2) / 2.0) - std::lgamma(d1 / 2.0) - std::lgamma(d2 / 2.0 + 1.0);
+                    return d2 / d1 * std::exp((log_scale - std::log(alpha)) * 2.0 / d2);
+                }
+                double a = 2.0 / (9.0 * d1), b = 2.0 / (9.0 * d2), z = normal_upper(alpha);
+                double qa = (1.0 - b) * (1.0 - b) - z * z * b;
+                double qb = -2.0 * (1.0 - a) * (1.0 - b);
+                double qc = (1.0 - a) * (1.0 - a) - z * z * a;
+                double discriminant = qb * qb - 4.0 * qa * qc;
+                if (qa <= 0.0 || discriminant < 0.0) return 1.0; //the heavy tails of small d2, where the root finder has to walk there
+                double y = (-qb + (z >= 0.0 ? 1.0 : -1.0) * std::sqrt(discriminant)) / (2.0 * qa);
+                return y > 0.0 ? y * y * y : 1.0;
+            }
+            //up to this many degrees of freedom the power-law tail starts closer than the expansions
+            static constexpr double SMALL_DF = 3.0;
+
+            /**
+             * @brief Halley's method on g(u) = log(tail probability) - log(target) against u = log x, for an x > 0 in the tail holding the smaller probability
+             * with s = x pdf / tail and l = x pdf' / pdf (log_slope), g' = -+s and g'' = -+s (1 + l) - s^2, so a step costs one cdf and one pdf.
+             * the error after a step is about the cube of the step, so a step below cbrt(tolerance) is the last one.
+            */
+            template <typename Dist, typename LogSlope>
+            double halley(const Dist& dist, LogSlope&& log_slope, double alpha, double x) {
+                bool upper_tail = alpha <= 0.5;
+                double sign = upper_tail ? -1.0 : 1.0;
+                double log_target = std::log(upper_tail ? alpha : 1.0 - alpha);
+                double last_step = std::cbrt(tolerance);
+                double u = std::log(x);
+                for (int i = 0; i < MAX_ITERATIONS; i++) {
+                    iterations++;
+                    double tail = upper_tail ? boost::math::cdf(boost::math::complement(dist, x)) : boost::math::cdf(dist, x);
+                    double s = x * boost::math::pdf(dist, x) / tail;
+                    if (!(tail > 0.0) || !(s > 0.0) || !std::isfinite(s)) return std::numeric_limits<double>::quiet_NaN();
+                    double g = std::log(tail) - log_target, g1 = sign * s, g2 = sign * s * (1.0 + log_slope(x)) - s * s;
+                    double step = -2.0 * g * g1 / (2.0 * g1 * g1 - g * g2);
+                    //far from the root the log tail may still bend; Newton then, and a factor of e per step at most, keeps the iteration in range
+                    if (!std::isfinite(step) || std::fabs(step) > 1.0) step = -g / g1;
+                    if (step > 1.0) step = 1.0;
+                    if (step < -1.0) step = -1.0;
+                    u += step;
+                    x = std::exp(u);
+                    if (std::fabs(step) <= last_step) return x;
+                }
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+
+            static double asymptotic_seed(Distribution distribution, double nu1, double nu2, double alpha) {
+                switch (distribution) {
+                case Distribution::chi_squared:
+                    return chi_squared_seed(nu1, alpha);
+                case Distribution::students_t:
+                    return students_t_seed(nu1, alpha);
+                default:
+                    return fisher_f_seed(nu1, nu2, alpha);
+                }
+            }
+
+            /**
+             * @brief the asymptotic seed times the ratio of solved value to seed at the preceding cells, extrapolated linearly from the last two
+             * the ratio drifts slowly with the degrees of freedom, so its extrapolation lands closer than the expansion alone does.
+            */
+            static double seed(const Key& key, std::span<const double> preceding) {
+                bool on_nu2 = key.distribution == Distribution::fisher_f;
+                double nu = on_nu2 ? key.nu2 : key.nu1;
+                auto ratio = [&](std::size_t back) {
+                    double q = preceding[preceding.size() - back], shifted = nu - static_cast<double>(back);
+                    double start = asymptotic_seed(key.distribution, on_nu2 ? key.nu1 : shifted, on_nu2 ? shifted : 0.0, key.alpha);
+                    return q > 0.0 && start > 0.0 && shifted >= 1.0 ? q / start : std::numeric_limits<double>::quiet_NaN();
+                };
+                double rtrn = asymptotic_seed(key.distribution, key.nu1, key.nu2, key.alpha);
+                double correction = preceding.size() >= 1 ? ratio(1) : std::numeric_limits<double>::quiet_NaN();
+                if (preceding.size() >= 2) {
+                    double extrapolated = 2.0 * correction - ratio(2);
+                    if (extrapolated > 0.0) correction = extrapolated;
+                }
+                return correction > 0.0 ? rtrn * correction : rtrn;
+            }
+
+            double solve(const Key& key, std::span<const double> preceding) {
+                solves++;
+                double nu1 = key.nu1, nu2 = key.nu2, alpha = key.alpha;
+                if (key.distribution == Distribution::students_t) {
+                    //symmetric about 0: solve the upper half only
+                    if (alpha == 0.5) return 0.0;
+                    if (alpha > 0.5) {
+                        std::vector<double> mirrored(preceding.begin(), preceding.end());
+                        for (double& q : mirrored) q = -q;
+                        return -upper(key.distribution, nu1, 0.0, 1.0 - alpha, mirrored);
+                    }
+                    //closed forms for 1 and 2 degrees of freedom; cot(pi alpha) rather than tan(pi (1/2 - alpha)), which loses digits to the pole
+                    if (nu1 == 1.0) return 1.0 / std::tan(std::numbers::pi * alpha);
+                    if (nu1 == 2.0) return (1.0 - 2.0 * alpha) / std::sqrt(2.0 * alpha * (1.0 - alpha));
+                }
+                double start = seed(key, preceding);
+                double rtrn = std::numeric_limits<double>::quiet_NaN();
+                //x pdf'(x) / pdf(x) of each density
+                switch (key.distribution) {
+                case Distribution::chi_squared:
+                    rtrn = halley(boost::math::chi_squared(nu1), [nu1](double x) { return nu1 / 2.0 - 1.0 - x / 2.0; }, alpha, start);
+                    break;
+                case Distribution::students_t:
+                    rtrn = halley(boost::math::students_t(nu1), [nu1](double x) { return -(nu1 + 1.0) * x * x / (nu1 + x * x); }, alpha, start);
+                    break;
+                case Distribution::fisher_f:
+                    rtrn = halley(boost::math::fisher_f(nu1, nu2), [nu1, nu2](double x) { return nu1 / 2.0 - 1.0 - (nu1 + nu2) / 2.0 * nu1 * x / (nu2 + nu1 * x); }, alpha, start);
+                    break;
+                }
+                if (!std::isnan(rtrn)) return rtrn;
+                fallbacks++;
+                switch (key.distribution) {
+                case Distribution::chi_squared:
+                    return boost::math::quantile(boost::math::complement(boost::math::chi_squared(nu1), alpha));
+                case Distribution::students_t:
+                    return boost::math::quantile(boost::math::complement(boost::math::students_t(nu1), alpha));
+                default:
+                    return boost::math::quantile(boost::math::complement(boost::math::fisher_f(nu1, nu2), alpha));
+                }
+            }
+
+            std::string cache_path;
+            double tolerance;
+            std::unordered_map<Key, double, KeyHash> cache;
+            bool dirty = false;
+            mutable std::mutex cache_mutex;
+            std::atomic<std::size_t> queries = 0, cache_hits = 0, solves = 0, iterations = 0, fallbacks = 0;
+        };
+    }
+}
+
+#endif
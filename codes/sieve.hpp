@@ -0,0 +1,276 @@
+#ifndef UMJCUTIL_MATH_SIEVE_HPP
+#define UMJCUTIL_MATH_SIEVE_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "isqrt.hpp"
+#include "thread-pool.hpp"
+
+namespace UMJCUtil {
+    namespace Math {
+        //mod-30 wheel: only the 8 residues coprime to 30 can hold a prime above 5, so one byte covers 30 integers.
+        //bit k of byte b stands for the integer 30 * b + RESIDUES[k].
+        namespace Wheel30 {
+            inline constexpr std::array<std::uint8_t, 8> RESIDUES = { 1, 7, 11, 13, 17, 19, 23, 29 };
+            //distance from RESIDUES[k] to the next residue on the wheel
+            inline constexpr std::array<std::uint8_t, 8> GAPS = { 6, 4, 2, 4, 2, 4, 6, 2 };
+            //bit mask of residue r, 0 when r shares a factor with 30
+            inline constexpr std::array<std::uint8_t, 30> BIT_OF = [] {
+                std::array<std::uint8_t, 30> rtrn = {};
+                for (std::size_t k = 0; k < RESIDUES.size(); k++) rtrn[RESIDUES[k]] = std::uint8_t(1u << k);
+                return rtrn;
+            }();
+            //index of the first residue >= r, 8 when r > 29 on this turn of the wheel
+            inline constexpr std::array<std::uint8_t, 31> NEXT_INDEX = [] {
+                std::array<std::uint8_t, 31> rtrn = {};
+                for (std::size_t r = 0; r <= 30; r++) {
+                    std::uint8_t k = 0;
+                    while (k < 8 && RESIDUES[k] < r) k++;
+                    rtrn[r] = k;
+                }
+                return rtrn;
+            }();
+            //bits of a byte whose integers are >= 30 * b + r
+            constexpr std::uint8_t mask_from(std::uint64_t r) {
+                return r >= 30 ? std::uint8_t(0) : std::uint8_t(0xff << NEXT_INDEX[r]);
+            }
+            //bits of a byte whose integers are <= 30 * b + r
+            constexpr std::uint8_t mask_up_to(std::uint64_t r) {
+                return std::uint8_t(~mask_from(r + 1));
+            }
+            //crossing off p * q for p = 30a + RESIDUES[i] and q = RESIDUES[k] (mod 30):
+            //the multiple lives in byte a * q + floor(RESIDUES[i] * q / 30), at bit CROSS_BIT[i][k],
+            //and stepping q to the next residue moves it a * GAPS[k] + CROSS_STEP[i][k] bytes forward.
+            inline constexpr std::array<std::array<std::uint8_t, 8>, 8> CROSS_BIT = [] {
+                std::array<std::array<std::uint8_t, 8>, 8> rtrn = {};
+                for (std::size_t i = 0; i < 8; i++) {
+                    for (std::size_t k = 0; k < 8; k++) rtrn[i][k] = BIT_OF[(RESIDUES[i] * RESIDUES[k]) % 30];
+                }
+                return rtrn;
+            }();
+            inline constexpr std::array<std::array<std::uint8_t, 8>, 8> CROSS_STEP = [] {
+                std::array<std::array<std::uint8_t, 8>, 8> rtrn = {};
+                for (std::size_t i = 0; i < 8; i++) {
+                    for (std::size_t k = 0; k < 8; k++) {
+                        rtrn[i][k] = std::uint8_t(RESIDUES[i] * (RESIDUES[k] + GAPS[k]) / 30 - RESIDUES[i] * RESIDUES[k] / 30);
+                    }
+                }
+                return rtrn;
+            }();
+        }
+
+        /**
+         * @brief segmented sieve of Eratosthenes over the mod-30 wheel
+         * sieves [low, high] one cache-sized segment at a time, so memory stays O(segment + sqrt(high)) no matter how wide the interval is.
+         * the caller passes every prime up to isqrt(high) (2, 3 and 5 are allowed and skipped, the wheel takes care of them).
+        */
+        class SegmentedSieve {
+        public:
+            //fits in a typical 32KiB L1 data cache
+            static constexpr std::size_t L1_SEGMENT_BYTES = std::size_t(32) * 1024;
+            //fits in a typical 256KiB+ L2 cache; used once sieving primes outgrow an L1 segment
+            static constexpr std::size_t L2_SEGMENT_BYTES = std::size_t(256) * 1024;
+            //crossing off may run up to 6 * sqrt(high) past the end of a segment, so keep that away from overflow
+            static constexpr std::uint64_t MAX_HIGH = std::numeric_limits<std::uint64_t>::max() - (std::uint64_t(1) << 36);
+
+            //a segment should span at least the largest sieving prime, but never spill out of L2.
+            static constexpr std::size_t segment_bytes_for(std::uint64_t high) {
+                std::uint64_t wanted = isqrt(high) / 30 + 1;
+                if (wanted <= L1_SEGMENT_BYTES) return L1_SEGMENT_BYTES;
+                if (wanted >= L2_SEGMENT_BYTES) return L2_SEGMENT_BYTES;
+                return std::size_t(std::bit_ceil(wanted));
+            }
+
+            template <typename Iterator>
+            SegmentedSieve(std::uint64_t low, std::uint64_t high, Iterator base_first, Iterator base_last, std::size_t segment_bytes = 0)
+                : low(low), high(high), next_byte(low / 30), last_byte(high / 30), active(0) {
+                if (high > MAX_HIGH) throw std::domain_error("the sieve interval exceeds the supported range");
+                if (segment_bytes == 0) segment_bytes = segment_bytes_for(high);
+                buffer.resize(segment_bytes);
+                if (low > high) {
+                    next_byte = last_byte + 1;
+                    return;
+                }
+                std::uint64_t root = isqrt(high);
+                std::uint64_t start = next_byte * 30;
+                for (; base_first != base_last; ++base_first) {
+                    std::uint64_t p = static_cast<std::uint64_t>(*base_first);
+                    if (p < 7) continue;
+                    if (p > root) break;
+                    //first multiple p * q >= max(p * p, start) with q coprime to 30
+                    std::uint64_t q = start / p + (start % p != 0);
+                    if (q < p) q = p;
+                    std::uint64_t r = q % 30;
+                    std::uint8_t k = Wheel30::NEXT_INDEX[r];
+                    if (k == 8) {
+                        q += 30 - r + 1;
+                        k = 0;
+                    }
+                    else {
+                        q += Wheel30::RESIDUES[k] - r;
+                    }
+                    sieving.push_back({ p * q / 30, static_cast<std::uint32_t>(p), static_cast<std::uint32_t>(p / 30), Wheel30::NEXT_INDEX[p % 30], k });
+                }
+            }
+
+            //sieves the next segment; returns false once the interval is exhausted.
+            bool next_segment() {
+                if (next_byte > last_byte) return false;
+                segment_first = next_byte;
+                segment_size = static_cast<std::size_t>(std::min<std::uint64_t>(buffer.size(), last_byte - next_byte + 1));
+                next_byte += segment_size;
+                std::uint8_t* bits = buffer.data();
+                std::memset(bits, 0xff, segment_size);
+                if (segment_first == 0) bits[0] &= std::uint8_t(~1u); //1 is not a prime
+                std::uint64_t end = next_byte * 30;
+                //sieving primes are sorted, so the ones whose square is beyond this segment are all at the tail
+                while (active < sieving.size() && std::uint64_t(sieving[active].prime) * sieving[active].prime < end) active++;
+                for (std::size_t i = 0; i < active; i++) {
+                    std::uint64_t byte = sieving[i].byte;
+                    std::uint64_t a = sieving[i].quotient;
+                    const auto& cross_bit = Wheel30::CROSS_BIT[sieving[i].residue];
+                    const auto& cross_step = Wheel30::CROSS_STEP[sieving[i].residue];
+                    std::uint8_t k = sieving[i].index;
+                    while (byte < next_byte) {
+                        bits[byte - segment_first] &= std::uint8_t(~cross_bit[k]);
+                        byte += a * Wheel30::GAPS[k] + cross_step[k];
+                        k = (k + 1) & 7;
+                    }
+                    sieving[i].byte = byte;
+                    sieving[i].index = k;
+                }
+                if (segment_first == low / 30) bits[0] &= Wheel30::mask_from(low % 30);
+                if (next_byte - 1 == last_byte) bits[segment_size - 1] &= Wheel30::mask_up_to(high % 30);
+                return true;
+            }
+
+            //calls callback(p) for every prime of the current segment in ascending order
+            template <typename Callback>
+            void for_each_prime_in_segment(Callback&& callback) const {
+                if (segment_first == 0) {
+                    for (std::uint64_t p : { 2, 3, 5 }) {
+                        if (low <= p && p <= high) callback(p);
+                    }
+                }
+                for (std::size_t i = 0; i < segment_size; i++) {
+                    std::uint32_t byte = buffer[i];
+                    std::uint64_t base = (segment_first + i) * 30;
+                    while (byte) {
+                        callback(base + Wheel30::RESIDUES[std::countr_zero(byte)]);
+                        byte &= byte - 1;
+                    }
+                }
+            }
+
+            std::uint64_t count_in_segment() const {
+                std::uint64_t rtrn = 0;
+                if (segment_first == 0) {
+                    for (std::uint64_t p : { 2, 3, 5 }) {
+                        if (low <= p && p <= high) rtrn++;
+                    }
+                }
+                std::size_t i = 0;
+                for (; i + 8 <= segment_size; i += 8) {
+                    std::uint64_t word;
+                    std::memcpy(&word, buffer.data() + i, sizeof(word));
+                    rtrn += std::popcount(word);
+                }
+                for (; i < segment_size; i++) rtrn += std::popcount(buffer[i]);
+                return rtrn;
+            }
+
+            template <typename Callback>
+            void for_each_prime(Callback&& callback) {
+                while (next_segment()) for_each_prime_in_segment(callback);
+            }
+
+            std::uint64_t count() {
+                std::uint64_t rtrn = 0;
+                while (next_segment()) rtrn += count_in_segment();
+                return rtrn;
+            }
+
+            //every prime up to n, finding the sieving primes up to isqrt(n) the same way first
+            static std::vector<std::uint64_t> primes_up_to(std::uint64_t n) {
+                std::vector<std::uint64_t> base = n < 49 ? std::vector<std::uint64_t>{} : primes_up_to(isqrt(n));
+                std::vector<std::uint64_t> rtrn = {};
+                SegmentedSieve(0, n, base.begin(), base.end()).for_each_prime([&](std::uint64_t p) { rtrn.push_back(p); });
+                return rtrn;
+            }
+
+            /**
+             * @brief pi(high) - pi(low - 1), sieved in chunks on the shared thread pool
+             * @param concurrency: at most this many threads, 0 for the pool's setting
+            */
+            template <typename Iterator>
+            static std::uint64_t count_parallel(std::uint64_t low, std::uint64_t high, Iterator base_first, Iterator base_last, std::size_t concurrency = 0) {
+                if (low > high) return 0;
+                std::vector<std::uint64_t> counts(chunk_count(low, high));
+                ThreadPool::shared().parallel_for(counts.size(), [&](std::size_t c) {
+                    auto [chunk_low, chunk_high] = chunk_bounds(low, high, c);
+                    counts[c] = SegmentedSieve(chunk_low, chunk_high, base_first, base_last).count();
+                }, concurrency);
+                std::uint64_t rtrn = 0;
+                for (auto count : counts) rtrn += count;
+                return rtrn;
+            }
+
+            //pushes the primes of [low, high] back onto out in ascending order, sieving chunks on the shared thread pool
+            template <typename Output, typename Iterator>
+            static void collect_parallel(std::uint64_t low, std::uint64_t high, Iterator base_first, Iterator base_last, Output& out, std::size_t concurrency = 0) {
+                using T = typename Output::value_type;
+                if (low > high) return;
+                std::vector<std::vector<T>> chunks(chunk_count(low, high));
+                ThreadPool::shared().parallel_for(chunks.size(), [&](std::size_t c) {
+                    auto [chunk_low, chunk_high] = chunk_bounds(low, high, c);
+                    SegmentedSieve(chunk_low, chunk_high, base_first, base_last).for_each_prime([&](std::uint64_t p) { chunks[c].push_back(static_cast<T>(p)); });
+                }, concurrency);
+                for (const auto& chunk : chunks) {
+                    for (const auto& p : chunk) out.push_back(p);
+                }
+            }
+
+            //wheel bytes of the current segment; byte i covers [30 * (segment_first_byte() + i), 30 * (segment_first_byte() + i + 1))
+            const std::uint8_t* segment_data() const { return buffer.data(); }
+            std::size_t segment_bytes() const { return segment_size; }
+            std::uint64_t segment_first_byte() const { return segment_first; }
+
+        private:
+            //parallel work is handed out in chunks of a few whole segments, so every chunk pays its setup only once per few segments
+            static constexpr std::size_t SEGMENTS_PER_CHUNK = 4;
+            static std::uint64_t chunk_span(std::uint64_t high) {
+                return std::uint64_t(segment_bytes_for(high)) * SEGMENTS_PER_CHUNK * 30;
+            }
+            static std::size_t chunk_count(std::uint64_t low, std::uint64_t high) {
+                return static_cast<std::size_t>((high - low / 30 * 30) / chunk_span(high) + 1);
+            }
+            static std::pair<std::uint64_t, std::uint64_t> chunk_bounds(std::uint64_t low, std::uint64_t high, std::size_t c) {
+                std::uint64_t first = low / 30 * 30 + c * chunk_span(high);
+                return { std::max(first, low), std::min(first + chunk_span(high) - 1, high) };
+            }
+
+            struct SievingPrime {
+                std::uint64_t byte; //wheel byte of the next multiple to cross off
+                std::uint32_t prime;
+                std::uint32_t quotient; //prime / 30
+                std::uint8_t residue; //wheel index of prime % 30
+                std::uint8_t index; //wheel index of multiple / prime
+            };
+            std::uint64_t low, high;
+            std::uint64_t next_byte, last_byte;
+            std::uint64_t segment_first = 0;
+            std::size_t segment_size = 0;
+            std::size_t active;
+            std::vector<SievingPrime> sieving;
+            std::vector<std::uint8_t> buffer;
+        };
+    }
+}
+
+#endif
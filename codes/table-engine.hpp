@@ -0,0 +1,98 @@
+#ifndef UMJCUTIL_TABLES_TABLE_ENGINE_HPP
+#define UMJCUTIL_TABLES_TABLE_ENGINE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "format-sink.hpp"
+#include "thread-pool.hpp"
+
+namespace UMJCUtil {
+    namespace Tables {
+        /**
+         * @brief a table described by its axes, what goes in a cell and how it is written
+         * rendered as
+         *   header
+         *       row_label(r) & cell(r, 0) & ... & cell(r, columns - 1)\\
+         *       \hline                                  (after every rule_every rows)
+         *   footer
+        */
+        struct Table {
+            std::string header;
+            std::size_t rows = 0;
+            std::size_t columns = 0;
+            std::function<std::string(std::size_t row)> row_label;
+            std::function<double(std::size_t row, std::size_t column)> cell;
+            //used instead of cell when set: the rows of a column are evaluated in order, each given the values above it (nearest last),
+            //so a cell that is solved iteratively can start from its neighbours; columns still run in parallel.
+            std::function<double(std::size_t row, std::size_t column, std::span<const double> above)> chained_cell;
+            SciFormat format;
+            std::size_t rule_every = 0; //0: no rules between rows
+            std::string footer;
+        };
+
+        /**
+         * @brief writes the tables one after another
+         * every cell of every table is evaluated first, in parallel on the shared ThreadPool, so a large document
+         * takes about (total cell cost) / (core count); the text is then formatted in order into one buffer and written at once, so the output is the same for any core count.
+         * @param concurrency: at most this many threads work on the cells, 0 for the pool's setting
+        */
+        inline void render(std::ostream& out, const std::vector<Table>& tables, std::size_t concurrency = 0) {
+            std::vector<std::size_t> first_cell = { 0 };
+            for (const Table& table : tables) first_cell.push_back(first_cell.back() + table.rows * table.columns);
+            std::vector<double> values(first_cell.back());
+            //one index per cell, or per column of a chained table: costs differ a lot between cells
+            //(an F quantile at r = 1 against one at r = 30), and single indices balance that
+            struct Unit {
+                std::size_t table;
+                std::size_t cell; //the column of a chained table
+            };
+            std::vector<Unit> units;
+            for (std::size_t t = 0; t < tables.size(); t++) {
+                std::size_t count = tables[t].chained_cell ? tables[t].columns : tables[t].rows * tables[t].columns;
+                for (std::size_t i = 0; i < count; i++) units.push_back({ t, i });
+            }
+            ThreadPool::shared().parallel_for(units.size(), [&](std::size_t k) {
+                const Table& table = tables[units[k].table];
+                double* cells = values.data() + first_cell[units[k].table];
+                if (table.chained_cell) {
+                    std::size_t c = units[k].cell;
+                    std::vector<double> column;
+                    column.reserve(table.rows);
+                    for (std::size_t r = 0; r < table.rows; r++) {
+                        column.push_back(table.chained_cell(r, c, column));
+                        cells[r * table.columns + c] = column.back();
+                    }
+                    return;
+                }
+                std::size_t i = units[k].cell;
+                cells[i] = table.cell(i / table.columns, i % table.columns);
+            }, concurrency);
+
+            FormatSink sink(out);
+            for (std::size_t t = 0; t < tables.size(); t++) {
+                const Table& table = tables[t];
+                sink.text(table.header);
+                for (std::size_t r = 0; r < table.rows; r++) {
+                    sink.text("    ").text(table.row_label(r)).text(" & ");
+                    for (std::size_t c = 0; c < table.columns; c++) {
+                        sink.sci(values[first_cell[t] + r * table.columns + c], table.format);
+                        sink.text(c + 1 < table.columns ? " & " : "\\\\\n");
+                    }
+                    if (table.rule_every != 0 && (r + 1) % table.rule_every == 0) sink.text("    \\hline\n");
+                }
+                sink.text(table.footer);
+            }
+            sink.flush();
+        }
+        inline void render(std::ostream& out, const Table& table, std::size_t concurrency = 0) {
+            render(out, std::vector<Table>{ table }, concurrency);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef UMJCUTIL_MATH_TABLE_FUNCTIONS_HPP
+#define UMJCUTIL_MATH_TABLE_FUNCTIONS_HPP
+
+#include <cmath>
+#include <numbers>
+
+//the functions the LaTeX tables print, with the grid each table walks.
+//a grid is FIRST / DIVISOR, (FIRST + 1) / DIVISOR, ..., LAST / DIVISOR; the domain a LookupTable covers is [LOWER, UPPER],
+//which runs one step past the last printed argument.
+//value() is what the generators print, reference() the same function in long double for checking tables against.
+
+namespace UMJCUtil {
+    namespace Math {
+        //P(0 < Z < z) of the standard normal distribution, z = 0.00, ..., 3.99
+        struct StandardNormalArea {
+            static constexpr int FIRST = 0;
+            static constexpr int LAST = 399;
+            static constexpr double DIVISOR = 100.0;
+            static constexpr double LOWER = FIRST / DIVISOR;
+            static constexpr double UPPER = (LAST + 1) / DIVISOR;
+
+            static double argument(int k) {
+                return static_cast<double>(k) / DIVISOR;
+            }
+            static double value(double z) {
+                return 0.5 * std::erf(z / std::numbers::sqrt2);
+            }
+            static long double reference(long double z) {
+                return 0.5L * std::erf(z / std::numbers::sqrt2_v<long double>);
+            }
+        };
+
+        //log10(x), x = 1.00, ..., 9.99
+        struct CommonLogarithm {
+            static constexpr int FIRST = 100;
+            static constexpr int LAST = 999;
+            static constexpr double DIVISOR = 100.0;
+            static constexpr double LOWER = FIRST / DIVISOR;
+            static constexpr double UPPER = (LAST + 1) / DIVISOR;
+
+            static double argument(int k) {
+                return static_cast<double>(k) / DIVISOR;
+            }
+            static double value(double x) {
+                return std::log10(x);
+            }
+            static long double reference(long double x) {
+                return std::log10(x);
+            }
+        };
+
+        //sin(x pi / 2), x = 0.000, ..., 0.999
+        struct QuarterSine {
+            static constexpr int FIRST = 0;
+            static constexpr int LAST = 999;
+            static constexpr double DIVISOR = 1000.0;
+            static constexpr double LOWER = FIRST / DIVISOR;
+            static constexpr double UPPER = (LAST + 1) / DIVISOR;
+
+            static double argument(int k) {
+                return static_cast<double>(k) / DIVISOR;
+            }
+            static double value(double x) {
+                return std::sin(x * (std::numbers::pi / 2.0));
+            }
+            static long double reference(long double x) {
+                return std::sin(x * (std::numbers::pi_v<long double> / 2.0L));
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include "primes.hpp"
+#include "miller-rabin.hpp"
+#include "sieve.hpp"
+#include "thread-pool.hpp"
+
+using UMJCUtil::Math::Primes;
+namespace MillerRabin = UMJCUtil::Math::MillerRabin;
+
+//usage: test-primes-concurrency [readers] [writers] [limit] [step]
+//readers call Primes<T>::is_prime(), pi() and get_prefounds() while writers list primes near r^2 for r rising to limit,
+//which extends the shared store of the primes up to r, step by step (4 readers, 2 writers, 10^6 and 10^4 by default).
+//every answer is checked against a sieve and every snapshot has to hold exactly the primes up to its limit(), in order;
+//exits with 1 on a wrong answer. `make tsan` builds it with -fsanitize=thread and runs it, so the races are checked as well.
+int main(int argc, char* argv[]) {
+    const std::size_t readers = argc > 1 ? std::stoul(argv[1]) : 4;
+    const std::size_t writers = argc > 2 ? std::stoul(argv[2]) : 2;
+    const std::uint64_t limit = argc > 3 ? std::stoull(argv[3]) : 1'000'000;
+    const std::uint64_t step = argc > 4 ? std::stoull(argv[4]) : 10'000;
+    //workers in the shared pool even on one core, so pi()'s parallel sieve races the rest too
+    UMJCUtil::ThreadPool::set_shared_concurrency(4);
+    const std::vector<std::uint64_t> expected = UMJCUtil::Math::SegmentedSieve::primes_up_to(limit);
+    auto expected_pi = [&expected](std::uint64_t n) { return static_cast<std::size_t>(std::upper_bound(expected.begin(), expected.end(), n) - expected.begin()); };
+
+    //the store starts at the seed table, so the writers' first roots already extend it
+    std::atomic<std::uint64_t> next_root = UMJCUtil::Math::SEED_LIMIT + step;
+    std::atomic<bool> done = false;
+    std::atomic<std::size_t> checks = 0, failures = 0;
+    auto check = [&](bool ok, const char* what, std::uint64_t n) {
+        checks++;
+        if (ok) return;
+        if (failures++ == 0) std::cerr << what << " is wrong at " << n << "\n";
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t r = 0; r < readers; r++) {
+        threads.emplace_back([&, r] {
+            std::mt19937_64 engine(r);
+            for (std::size_t round = 0; true; round++) {
+                //read done first: the snapshot after it has seen every extension
+                bool last = done.load();
+                auto snapshot = Primes<std::uint64_t>::get_prefounds();
+                std::uint64_t snapshot_limit = snapshot.limit();
+                check(snapshot.size() == expected_pi(std::min(snapshot_limit, limit)) && std::is_sorted(snapshot.begin(), snapshot.end())
+                    && std::equal(snapshot.begin(), snapshot.begin() + std::min<std::size_t>(snapshot.size(), expected.size()), expected.begin()), "get_prefounds()", snapshot_limit);
+                //the ranges of both sides of the store's current limit, through two instantiations that share it
+                std::uint64_t x = engine() % (limit + 1);
+                check(Primes<std::uint32_t>::is_prime(static_cast<std::uint32_t>(x)) == std::binary_search(expected.begin(), expected.end(), x), "Primes<uint32_t>::is_prime()", x);
+                check(Primes<std::int64_t>::is_prime(static_cast<std::int64_t>(x)) == std::binary_search(expected.begin(), expected.end(), x), "Primes<int64_t>::is_prime()", x);
+                std::uint64_t n = engine() % (std::min(snapshot_limit, limit) + 1);
+                check(Primes<std::uint32_t>::pi(static_cast<std::uint32_t>(n)) == expected_pi(n), "Primes<uint32_t>::pi()", n);
+                //past the store, pi() sieves the rest on the shared ThreadPool; that is slower, so only now and then
+                if (round % 64 == 0) check(Primes<std::uint64_t>::pi(x) == expected_pi(x), "Primes<uint64_t>::pi()", x);
+                if (last) return;
+            }
+        });
+    }
+    std::vector<std::thread> writer_threads;
+    for (std::size_t w = 0; w < writers; w++) {
+        writer_threads.emplace_back([&] {
+            constexpr std::uint64_t WIDTH = 200;
+            for (std::uint64_t root = next_root.fetch_add(step); root <= limit; root = next_root.fetch_add(step)) {
+                //primes_between() extends the store to isqrt(b) before listing
+                std::uint64_t b = root * root, a = b - WIDTH;
+                std::vector<std::uint64_t> listed;
+                for (std::uint64_t p : Primes<std::uint64_t>::primes_between(a, b)) listed.push_back(p);
+                std::vector<std::uint64_t> reference;
+                for (std::uint64_t n = a; n <= b; n++) {
+                    if (MillerRabin::is_prime(n)) reference.push_back(n);
+                }
+                check(listed == reference, "Primes<uint64_t>::primes_between()", b);
+            }
+        });
+    }
+    for (auto& writer : writer_threads) writer.join();
+    done = true;
+    for (auto& reader : threads) reader.join();
+
+    auto final_snapshot = Primes<std::uint64_t>::get_prefounds();
+    check(final_snapshot.limit() >= limit - step, "the store's limit", final_snapshot.limit());
+    std::cout << readers << " readers, " << writers << " writers: " << checks << " checks up to " << final_snapshot.limit() << ", " << failures << " failed\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#ifndef UMJCUTIL_THREAD_POOL_HPP
+#define UMJCUTIL_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace UMJCUtil {
+    /**
+     * @brief work-stealing thread pool
+     * every worker owns a deque: it pops its own tasks from the back and steals from the front of the others when it runs dry.
+     * the thread calling parallel_for() works on its own loop too.
+    */
+    class ThreadPool {
+    public:
+        //concurrency counts the calling thread, so the pool starts concurrency - 1 workers.
+        explicit ThreadPool(std::size_t concurrency) : ThreadPool(concurrency, false) {}
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> sleep_lock(sleep_mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& worker : workers) worker.join();
+        }
+
+        /**
+         * @brief the process-wide pool, started on first use
+         * sized by set_shared_concurrency() if it was called before, std::thread::hardware_concurrency() otherwise.
+        */
+        static ThreadPool& shared() {
+            static ThreadPool pool(requested_concurrency().load() != 0 ? requested_concurrency().load() : std::max(1u, std::thread::hardware_concurrency()), true);
+            return pool;
+        }
+        //before the shared pool starts this sizes it; afterwards it caps how many threads each parallel_for() may use (0: no cap).
+        static void set_shared_concurrency(std::size_t concurrency) {
+            requested_concurrency().store(concurrency);
+        }
+
+        std::size_t concurrency() const {
+            std::size_t requested = is_shared ? requested_concurrency().load() : 0;
+            return requested != 0 ? std::min(requested, concurrency_cap) : concurrency_cap;
+        }
+
+        void submit(std::function<void()> task) {
+            if (queues.empty()) {
+                task();
+                return;
+            }
+            //tasks submitted by a worker stay on its own deque, others are spread round-robin
+            std::size_t home = current_pool == this ? current_index : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+            //counted before it can be taken, so the runner's pending-- never goes below zero
+            {
+                std::lock_guard<std::mutex> sleep_lock(sleep_mutex);
+                pending++;
+            }
+            {
+                std::lock_guard<std::mutex> queue_lock(queues[home]->mutex);
+                queues[home]->tasks.push_back(std::move(task));
+            }
+            wake.notify_one();
+        }
+
+        /**
+         * @brief calls func(i) for every i in [0, count) and waits for all of them
+         * indices are handed out one at a time, so uneven work per index balances itself.
+         * the caller works through the loop as well and never waits on a runner that has not claimed an index,
+         * so nested calls and calls made while holding a lock cannot deadlock on a busy pool.
+         * @param max_concurrency: at most this many threads (the caller included) work on the loop, 0 for concurrency()
+        */
+        template <typename Func>
+        void parallel_for(std::size_t count, Func&& func, std::size_t max_concurrency = 0) {
+            std::size_t runners = std::min(count, max_concurrency != 0 ? std::min(max_concurrency, concurrency()) : concurrency());
+            if (runners <= 1) {
+                for (std::size_t i = 0; i < count; i++) func(i);
+                return;
+            }
+            //runners that are dequeued after the loop is over only touch this state, which they keep alive themselves.
+            struct Loop {
+                std::atomic<std::size_t> next = 0;
+                std::atomic<std::size_t> in_flight = 0;
+                std::size_t count;
+                std::exception_ptr error = nullptr;
+                std::mutex error_mutex;
+            };
+            auto loop = std::make_shared<Loop>();
+            loop->count = count;
+            auto* body = &func;
+            auto run = [](Loop& loop, auto* body) {
+                loop.in_flight++;
+                try {
+                    for (std::size_t i = loop.next.fetch_add(1); i < loop.count; i = loop.next.fetch_add(1)) (*body)(i);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> error_lock(loop.error_mutex);
+                    if (!loop.error) loop.error = std::current_exception();
+                    loop.next.store(loop.count);
+                }
+                if (loop.in_flight.fetch_sub(1) == 1) loop.in_flight.notify_all();
+            };
+            for (std::size_t i = 0; i + 1 < runners; i++) submit([loop, body, run] { run(*loop, body); });
+            run(*loop, body);
+            //every index is claimed by now, so only the runners still inside func matter.
+            for (std::size_t left = loop->in_flight.load(); left != 0; left = loop->in_flight.load()) loop->in_flight.wait(left);
+            if (loop->error) std::rethrow_exception(loop->error);
+        }
+
+    private:
+        ThreadPool(std::size_t concurrency, bool is_shared) : concurrency_cap(std::max<std::size_t>(1, concurrency)), is_shared(is_shared) {
+            std::size_t worker_count = concurrency_cap - 1;
+            for (std::size_t i = 0; i < worker_count; i++) queues.push_back(std::make_unique<Queue>());
+            for (std::size_t i = 0; i < worker_count; i++) workers.emplace_back([this, i] { work(i); });
+        }
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        static std::atomic<std::size_t>& requested_concurrency() {
+            static std::atomic<std::size_t> rtrn(0);
+            return rtrn;
+        }
+
+        bool try_run_one(std::size_t home) {
+            if (queues.empty()) return false;
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> queue_lock(queues[home]->mutex);
+                if (!queues[home]->tasks.empty()) {
+                    task = std::move(queues[home]->tasks.back());
+                    queues[home]->tasks.pop_back();
+                }
+            }
+            for (std::size_t k = 1; !task && k < queues.size(); k++) {
+                Queue& victim = *queues[(home + k) % queues.size()];
+                std::lock_guard<std::mutex> queue_lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                }
+            }
+            if (!task) return false;
+            pending--;
+            task();
+            return true;
+        }
+
+        void work(std::size_t index) {
+            current_pool = this;
+            current_index = index;
+            while (true) {
+                if (try_run_one(index)) continue;
+                std::unique_lock<std::mutex> sleep_lock(sleep_mutex);
+                wake.wait(sleep_lock, [this] { return stopping || pending.load() != 0; });
+                if (stopping && pending.load() == 0) return;
+            }
+        }
+
+        std::size_t concurrency_cap;
+        bool is_shared;
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> workers;
+        std::atomic<std::size_t> next_queue = 0;
+        std::atomic<std::size_t> pending = 0;
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+        static inline thread_local ThreadPool* current_pool = nullptr;
+        static inline thread_local std::size_t current_index = 0;
+    };
+}
+
+#endif